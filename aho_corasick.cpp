@@ -0,0 +1,158 @@
+/*
+ * Filename: aho_corasick.cpp
+ * Programmer: Abdurrahman Alyajouri
+ * Date: 10/17/2026
+ * Purpose: The purpose of this file is to implement the AhoCorasick class
+ *          declared in "aho_corasick.h".
+ */
+
+#include "aho_corasick.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+//BEGINNING OF AHOCORASICK CLASS IMPLEMENTATION
+
+AhoCorasick::AhoCorasick() : class_count(0), stride(0), max_length(0) {}
+
+AhoCorasick::AhoCorasick(const vector<string>& literals) : AhoCorasick() {
+    if(literals.empty()) return;
+
+    //Every byte a literal uses gets a class of its own, all others share
+    //one, which only ever leads back towards the root.
+    for(const string& literal : literals) {
+        if(literal.empty()) return;
+        for(char c : literal) this->classes.AddRange(static_cast<unsigned char>(c), static_cast<unsigned char>(c));
+        this->max_length = std::max(this->max_length, literal.size());
+    }
+    this->classes.Build();
+    this->class_count = this->classes.GetCount();
+    this->stride = this->class_count + 2;
+
+    //Build the trie, with kNoRow for missing children. There is at most
+    //one node per byte of the literals, plus the root.
+    size_t total_length = 0;
+    for(const string& literal : literals) total_length += literal.size();
+    this->table.reserve(std::min(total_length + 1, kMaxTableEntries / this->stride) * this->stride);
+    this->table.assign(this->stride, kNoRow);
+    this->table[this->class_count] = 0;
+    this->table[this->class_count + 1] = 0;
+    for(const string& literal : literals) {
+        std::uint32_t row = 0;
+        for(char c : literal) {
+            size_t entry = row + this->classes.Get(static_cast<unsigned char>(c));
+            if(this->table[entry] == kNoRow) {
+                if(this->table.size() + this->stride > kMaxTableEntries) {
+                    this->table.clear();
+                    return;
+                }
+                std::uint32_t child = static_cast<std::uint32_t>(this->table.size());
+                std::uint32_t depth = GetDepth(row) + 1;
+                this->table.resize(this->table.size() + this->stride, kNoRow);
+                this->table[child + this->class_count] = depth;
+                this->table[child + this->class_count + 1] = 0;
+                this->table[entry] = child;
+            }
+            row = this->table[entry];
+        }
+        this->table[row + this->class_count + 1] = static_cast<std::uint32_t>(literal.size());
+    }
+
+    //Resolve the failure links breadth first, so a node's failure node is
+    //complete before the node is. Missing children become the transition
+    //the failure node takes, and every node also reports the longest
+    //literal its failure node reports, which is a suffix of its own.
+    vector<std::uint32_t> failure(this->table.size() / this->stride, 0);
+    vector<std::uint32_t> queue;
+    for(size_t k = 0; k < this->class_count; ++k) {
+        std::uint32_t& child = this->table[k];
+        if(child == kNoRow) child = 0;
+        else queue.push_back(child);
+    }
+    for(size_t head = 0; head < queue.size(); ++head) {
+        std::uint32_t row = queue[head];
+        std::uint32_t fail = failure[row / this->stride];
+        for(size_t k = 0; k < this->class_count; ++k) {
+            std::uint32_t& child = this->table[row + k];
+            if(child == kNoRow) {
+                child = this->table[fail + k];
+                continue;
+            }
+            std::uint32_t child_fail = this->table[fail + k];
+            failure[child / this->stride] = child_fail;
+            std::uint32_t& output = this->table[child + this->class_count + 1];
+            output = std::max(output, GetOutput(child_fail));
+            queue.push_back(child);
+        }
+    }
+    this->table.shrink_to_fit();
+}
+
+bool AhoCorasick::IsBuilt(void) const {
+    return !this->table.empty();
+}
+
+size_t AhoCorasick::GetStateCount(void) const {
+    return IsBuilt() ? this->table.size() / this->stride : 0;
+}
+
+size_t AhoCorasick::GetMemoryUsage(void) const {
+    return this->table.capacity() * sizeof(std::uint32_t);
+}
+
+bool AhoCorasick::Match(string_view input) const {
+    if(!IsBuilt()) return false;
+
+    //Follow the trie, failing as soon as a transition leaves it, which
+    //shows as the depth not growing by one.
+    std::uint32_t row = 0;
+    std::uint32_t depth = 0;
+    for(char c : input) {
+        row = this->table[row + this->classes.Get(static_cast<unsigned char>(c))];
+        if(GetDepth(row) != ++depth) return false;
+    }
+    return depth > 0 && GetOutput(row) == depth;
+}
+
+bool AhoCorasick::Find(string_view input, size_t pos, size_t& begin, size_t& end) const {
+    if(!IsBuilt()) return false;
+
+    //Find where the first literal ends. The longest literal ending there
+    //starts at "first_begin". A literal starting further left has to end
+    //further right, and can start at most "max_length" bytes to the left
+    //of the end, so only those few starting offsets are left to check.
+    std::uint32_t row = 0;
+    for(size_t i = pos; i < input.size(); ++i) {
+        row = this->table[row + this->classes.Get(static_cast<unsigned char>(input[i]))];
+        std::uint32_t output = GetOutput(row);
+        if(output == 0) continue;
+
+        size_t first_begin = i + 1 - output;
+        size_t earliest = i + 1 > this->max_length ? i + 1 - this->max_length : 0;
+        for(size_t start = std::max(pos, earliest); start <= first_begin; ++start) {
+            std::uint32_t length = GetLongestAt(input, start);
+            if(length == kNoRow) continue;
+            begin = start;
+            end = start + length;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::uint32_t AhoCorasick::GetLongestAt(string_view input, size_t pos) const {
+    std::uint32_t longest = kNoRow;
+    std::uint32_t row = 0;
+    std::uint32_t depth = 0;
+    for(size_t i = pos; i < input.size(); ++i) {
+        row = this->table[row + this->classes.Get(static_cast<unsigned char>(input[i]))];
+        if(GetDepth(row) != ++depth) break;
+        if(GetOutput(row) == depth) longest = depth;
+    }
+    return longest;
+}
+
+//END OF AHOCORASICK CLASS IMPLEMENTATION
@@ -0,0 +1,82 @@
+#pragma once
+
+/*
+ * Filename: aho_corasick.h
+ * Programmer: Abdurrahman Alyajouri
+ * Date: 10/17/2026
+ * Purpose: The purpose of this file is to define the AhoCorasick class, which
+ *          matches patterns that are nothing but an alternation of literal
+ *          strings, like "(Hello)|(Hi)" or a long list of words. The literals
+ *          are put in a trie, and the trie's failure links are resolved ahead
+ *          of time into a dense table indexed by byte class, so searching
+ *          takes exactly one table lookup per input byte no matter how many
+ *          literals there are.
+ */
+
+#include "byte_class.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using std::size_t;
+using std::string;
+using std::string_view;
+using std::vector;
+
+class AhoCorasick {
+    public:
+        //Largest number of table entries the automaton may have. Bigger
+        //literal sets are left unbuilt.
+        static constexpr size_t kMaxTableEntries = 1 << 24;
+
+        //Ctors. The first one creates an empty automaton that can't be used.
+        //The second one builds the automaton of "literals", unless one of
+        //them is empty or the table would be too big.
+        AhoCorasick();
+        explicit AhoCorasick(const vector<string>& literals);
+
+        //Returns true if the automaton was built and may be used.
+        bool IsBuilt(void) const;
+
+        //Returns the number of trie nodes, 0 if not built.
+        size_t GetStateCount(void) const;
+
+        //Returns an estimate of the memory the table uses, in bytes.
+        size_t GetMemoryUsage(void) const;
+
+        //Checks if the whole input is one of the literals.
+        bool Match(string_view input) const;
+
+        //Searches "input" for the leftmost literal that starts at or after
+        //"pos", preferring the longest one among those that start there,
+        //like Regex::Find. On a match, sets "begin" and "end" and returns
+        //true.
+        bool Find(string_view input, size_t pos, size_t& begin, size_t& end) const;
+
+    private:
+        //Each row of "table" holds the next row for every byte class,
+        //followed by two entries: the depth of the node in the trie, and
+        //the length of the longest literal that ends at the node, 0 if none.
+        //Rows are referred to by their offset in "table", so taking a
+        //transition needs no multiplication.
+        static constexpr std::uint32_t kNoRow = 0xFFFFFFFF;
+
+        std::uint32_t GetDepth(std::uint32_t row) const {
+            return this->table[row + this->class_count];
+        }
+        std::uint32_t GetOutput(std::uint32_t row) const {
+            return this->table[row + this->class_count + 1];
+        }
+
+        //Returns the length of the longest literal that starts at "pos", or
+        //kNoRow if none does.
+        std::uint32_t GetLongestAt(string_view input, size_t pos) const;
+
+        ByteClasses classes; //Classes of the bytes the literals use.
+        size_t class_count;
+        size_t stride; //Entries per row, "class_count" + 2.
+        vector<std::uint32_t> table; //Row 0 is the root, empty if not built.
+        size_t max_length; //Length of the longest literal.
+};
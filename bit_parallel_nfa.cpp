@@ -0,0 +1,219 @@
+/*
+ * Filename: bit_parallel_nfa.cpp
+ * Programmer: Abdurrahman Alyajouri
+ * Date: 10/17/2026
+ * Purpose: The purpose of this file is to implement the BitParallelNFA class
+ *          declared in "bit_parallel_nfa.h".
+ */
+
+#include "bit_parallel_nfa.h"
+#include <vector>
+
+using std::vector;
+
+//BEGINNING OF BITPARALLELNFA CLASS IMPLEMENTATION
+
+BitParallelNFA::BitParallelNFA() : position_count(0), word_count(0), chunk_bits(0) {}
+
+BitParallelNFA::BitParallelNFA(const TNFA& nfa) : BitParallelNFA() {
+    if(nfa.IsEmpty()) return;
+
+    //The positions of the Glushkov automaton are the states of "nfa" with
+    //a symbol transition. Position q follows position p if q is in the
+    //epsilon closure of the state p's symbol transition leads to.
+    vector<size_t> marks(nfa.GetStateCount(), 0);
+    vector<StateId> pending;
+    size_t step = 0;
+
+    //Writes the states with symbol transitions in the epsilon closure of
+    //"state" to "result", in the order a depth first walk taking the first
+    //epsilon transition first meets them. Returns true if the closure holds
+    //the accept state.
+    auto closure = [&](StateId state, vector<StateId>& result) {
+        ++step;
+        bool accepts = false;
+        result.clear();
+        marks[state] = step;
+        pending.assign(1, state);
+        while(!pending.empty()) {
+            const State& current = nfa.GetState(pending.back());
+            if(current.HasSymbolTransition()) result.push_back(pending.back());
+            pending.pop_back();
+            accepts = accepts || current.acceptance;
+            for(int i = current.epsilon_count - 1; i >= 0; --i) {
+                StateId next_state = current.epsilon_transitions[i];
+                if(marks[next_state] != step) {
+                    marks[next_state] = step;
+                    pending.push_back(next_state);
+                }
+            }
+        }
+        return accepts;
+    };
+
+    //Number the positions in depth first order from the initial state, so
+    //that runs of concatenated symbols get consecutive numbers and their
+    //transitions become plain shifts. Position 0 is the initial state.
+    vector<StateId> first;
+    bool nullable = closure(nfa.GetStartState(), first);
+
+    vector<size_t> numbers(nfa.GetStateCount(), 0);
+    vector<StateId> order;
+    vector<bool> finals;
+    vector<size_t> follow_begin;
+    vector<StateId> follow_states;
+    vector<StateId> follow;
+    vector<StateId> walk(first.rbegin(), first.rend());
+    while(!walk.empty()) {
+        StateId id = walk.back();
+        walk.pop_back();
+        if(numbers[id] != 0) continue;
+        if(order.size() == kMaxPositions) return;
+
+        order.push_back(id);
+        numbers[id] = order.size();
+        finals.push_back(closure(nfa.GetState(id).symbol_transition, follow));
+        follow_begin.push_back(follow_states.size());
+        follow_states.insert(follow_states.end(), follow.begin(), follow.end());
+        walk.insert(walk.end(), follow.rbegin(), follow.rend());
+    }
+    follow_begin.push_back(follow_states.size());
+
+    this->position_count = order.size();
+    this->word_count = (this->position_count + 1 + 63) / 64;
+    size_t words = this->word_count;
+    this->byte_masks.assign(256 * words, 0);
+    this->shift_mask.assign(words, 0);
+    this->final_mask.assign(words, 0);
+
+    for(size_t p = 1; p <= this->position_count; ++p) {
+        const State& state = nfa.GetState(order[p - 1]);
+        for(unsigned int c = state.low; c <= state.high; ++c) SetBit(&this->byte_masks[c * words], p);
+        if(finals[p - 1]) SetBit(this->final_mask.data(), p);
+    }
+    if(nullable) SetBit(this->final_mask.data(), 0);
+
+    //Sort the transitions into shifts and exceptions.
+    vector<std::uint64_t> exceptions((this->position_count + 1) * words, 0);
+    vector<bool> has_exception(this->position_count + 1, false);
+    auto add_transition = [&](size_t from, size_t to) {
+        if(to == from + 1) {
+            SetBit(this->shift_mask.data(), to);
+        } else {
+            SetBit(&exceptions[from * words], to);
+            has_exception[from] = true;
+        }
+    };
+    for(StateId id : first) add_transition(0, numbers[id]);
+    for(size_t p = 1; p <= this->position_count; ++p)
+        for(size_t i = follow_begin[p - 1]; i < follow_begin[p]; ++i)
+            add_transition(p, numbers[follow_states[i]]);
+
+    //A single word uses byte sized chunks. Wider masks use smaller ones to
+    //keep the tables from growing with the square of the word count.
+    this->chunk_bits = words == 1 ? 8 : 4;
+    size_t entries = size_t(1) << this->chunk_bits;
+    for(size_t chunk = 0; chunk * this->chunk_bits <= this->position_count; ++chunk) {
+        size_t low = chunk * this->chunk_bits;
+        bool needed = false;
+        for(size_t p = low; p < low + this->chunk_bits && p <= this->position_count; ++p)
+            needed = needed || has_exception[p];
+        if(!needed) continue;
+
+        //Each entry is the entry without its lowest bit, plus the
+        //exceptions of the position of that bit.
+        this->exception_chunks.push_back(static_cast<std::uint32_t>(chunk));
+        size_t table = this->exception_tables.size();
+        this->exception_tables.resize(table + entries * words, 0);
+        for(size_t v = 1; v < entries; ++v) {
+            size_t bit = 0;
+            while(!((v >> bit) & 1)) ++bit;
+            size_t p = low + bit;
+            for(size_t w = 0; w < words; ++w) {
+                std::uint64_t value = this->exception_tables[table + (v & (v - 1)) * words + w];
+                if(p <= this->position_count) value |= exceptions[p * words + w];
+                this->exception_tables[table + v * words + w] = value;
+            }
+        }
+    }
+}
+
+bool BitParallelNFA::IsBuilt(void) const {
+    return this->word_count != 0;
+}
+
+size_t BitParallelNFA::GetPositionCount(void) const {
+    return this->position_count;
+}
+
+size_t BitParallelNFA::GetMemoryUsage(void) const {
+    return (this->byte_masks.size() + this->shift_mask.size() + this->final_mask.size() +
+            this->exception_tables.size()) * sizeof(std::uint64_t) +
+           this->exception_chunks.size() * sizeof(std::uint32_t);
+}
+
+bool BitParallelNFA::Match(string_view input) const {
+    if(this->word_count == 1) return MatchOneWord(input);
+    return MatchWords(input);
+}
+
+bool BitParallelNFA::MatchOneWord(string_view input) const {
+    const std::uint64_t* masks = this->byte_masks.data();
+    const std::uint64_t* tables = this->exception_tables.data();
+    const std::uint32_t* chunks = this->exception_chunks.data();
+    size_t chunk_count = this->exception_chunks.size();
+    std::uint64_t shift = this->shift_mask[0];
+
+    //Bit p is set while position p is active.
+    std::uint64_t active = 1;
+    for(char c : input) {
+        std::uint64_t next = (active << 1) & shift;
+        for(size_t i = 0; i < chunk_count; ++i)
+            next |= tables[(i << 8) | ((active >> (chunks[i] * 8)) & 0xFF)];
+        active = next & masks[static_cast<unsigned char>(c)];
+        if(active == 0) return false;
+    }
+    return (active & this->final_mask[0]) != 0;
+}
+
+bool BitParallelNFA::MatchWords(string_view input) const {
+    size_t words = this->word_count;
+    size_t entries = size_t(1) << this->chunk_bits;
+    std::uint64_t chunk_mask = entries - 1;
+
+    std::uint64_t active[kMaxWords] = {1};
+    std::uint64_t next[kMaxWords] = {};
+    for(char c : input) {
+        std::uint64_t carry = 0;
+        for(size_t w = 0; w < words; ++w) {
+            next[w] = ((active[w] << 1) | carry) & this->shift_mask[w];
+            carry = active[w] >> 63;
+        }
+
+        for(size_t i = 0; i < this->exception_chunks.size(); ++i) {
+            size_t bit = this->exception_chunks[i] * this->chunk_bits;
+            size_t value = (active[bit / 64] >> (bit % 64)) & chunk_mask;
+            const std::uint64_t* row = &this->exception_tables[(i * entries + value) * words];
+            for(size_t w = 0; w < words; ++w) next[w] |= row[w];
+        }
+
+        const std::uint64_t* mask = &this->byte_masks[static_cast<unsigned char>(c) * words];
+        std::uint64_t any = 0;
+        for(size_t w = 0; w < words; ++w) {
+            active[w] = next[w] & mask[w];
+            any |= active[w];
+        }
+        if(any == 0) return false;
+    }
+
+    for(size_t w = 0; w < words; ++w)
+        if(active[w] & this->final_mask[w]) return true;
+    return false;
+}
+
+void BitParallelNFA::SetBit(std::uint64_t* mask, size_t bit) {
+    mask[bit / 64] |= std::uint64_t(1) << (bit % 64);
+    return;
+}
+
+//END OF BITPARALLELNFA CLASS IMPLEMENTATION
@@ -0,0 +1,76 @@
+#pragma once
+
+/*
+ * Filename: bit_parallel_nfa.h
+ * Programmer: Abdurrahman Alyajouri
+ * Date: 10/17/2026
+ * Purpose: The purpose of this file is to define the BitParallelNFA class,
+ *          which simulates the Glushkov automaton of a small pattern with
+ *          bit masks. The Glushkov automaton has no epsilon transitions and
+ *          one state per symbol position of the pattern, so the whole set of
+ *          active states fits in one machine word (or a few) and is advanced
+ *          over each input byte with a handful of shifts, ANDs and ORs, with
+ *          no cache to warm up.
+ */
+
+#include "tnfa.h"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+using std::size_t;
+using std::string_view;
+using std::vector;
+
+class BitParallelNFA {
+    public:
+        //Largest number of positions the simulation supports. Together with
+        //the initial state they fit in kMaxWords 64-bit words.
+        static constexpr size_t kMaxWords = 4;
+        static constexpr size_t kMaxPositions = 64 * kMaxWords - 1;
+
+        //Ctors. The first one creates an empty simulation that can't be
+        //used. The second one builds the Glushkov automaton of "nfa", unless
+        //it has more than kMaxPositions positions.
+        BitParallelNFA();
+        explicit BitParallelNFA(const TNFA& nfa);
+
+        //Returns true if the simulation was built and Match may be called.
+        bool IsBuilt(void) const;
+
+        //Returns the number of positions, or 0 if not built.
+        size_t GetPositionCount(void) const;
+
+        //Returns an estimate of the memory the tables use, in bytes.
+        size_t GetMemoryUsage(void) const;
+
+        //Checks if the whole input is matched, like Regex::Match.
+        bool Match(string_view input) const;
+
+    private:
+        //Single and multiple word versions of Match.
+        bool MatchOneWord(string_view input) const;
+        bool MatchWords(string_view input) const;
+
+        //Sets bit "bit" of the mask that starts at "mask".
+        static void SetBit(std::uint64_t* mask, size_t bit);
+
+        size_t position_count; //Number of positions, bit 0 is the initial state.
+        size_t word_count; //Words per mask, 0 if not built.
+
+        //Masks are "word_count" words long. Bit p of a mask stands for
+        //position p.
+        vector<std::uint64_t> byte_masks; //Positions that consume each byte.
+        vector<std::uint64_t> shift_mask; //Positions p that follow p - 1.
+        vector<std::uint64_t> final_mask; //Positions a match may end on.
+
+        //Every other follow transition is looked up a chunk of "chunk_bits"
+        //bits of the active set at a time. "exception_chunks" lists the
+        //chunks with such transitions, and "exception_tables" holds, for
+        //each of them in turn, the positions followed by every value of the
+        //chunk.
+        size_t chunk_bits;
+        vector<std::uint32_t> exception_chunks;
+        vector<std::uint64_t> exception_tables;
+};
@@ -0,0 +1,127 @@
+/*
+ * Filename: byte_class.cpp
+ * Programmer: Abdurrahman Alyajouri
+ * Date: 10/17/2026
+ * Purpose: The purpose of this file is to implement the ByteSet and
+ *          ByteClasses classes declared in "byte_class.h".
+ */
+
+#include "byte_class.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+using std::vector;
+
+//BEGINNING OF BYTESET CLASS IMPLEMENTATION
+
+ByteSet::ByteSet() {}
+
+void ByteSet::Add(unsigned char c) {
+    this->bytes.set(c);
+    return;
+}
+
+void ByteSet::AddRange(unsigned char low, unsigned char high) {
+    for(int c = low; c <= high; ++c) this->bytes.set(c);
+    return;
+}
+
+void ByteSet::AddSet(const ByteSet& a_set) {
+    this->bytes |= a_set.bytes;
+    return;
+}
+
+void ByteSet::Negate(void) {
+    this->bytes.flip();
+    return;
+}
+
+bool ByteSet::Contains(unsigned char c) const {
+    return this->bytes.test(c);
+}
+
+bool ByteSet::IsEmpty(void) const {
+    return this->bytes.none();
+}
+
+size_t ByteSet::GetCount(void) const {
+    return this->bytes.count();
+}
+
+unsigned char ByteSet::GetMin(void) const {
+    const bitset<256> kWord(~0ULL);
+    int c = 0;
+    while(c < 192 && ((this->bytes >> c) & kWord).none()) c += 64;
+    while(c < 255 && !this->bytes[c]) ++c;
+    return static_cast<unsigned char>(c);
+}
+
+bool ByteSet::operator==(const ByteSet& a_set) const {
+    return this->bytes == a_set.bytes;
+}
+
+vector<pair<unsigned char, unsigned char>> ByteSet::GetRanges(void) const {
+    //Whole words of 64 bytes that are not in the set are skipped at once,
+    //since most sets are a handful of bytes.
+    const bitset<256> kWord(~0ULL);
+    std::uint64_t words[4];
+    for(int k = 0; k < 4; ++k) words[k] = ((this->bytes >> (64 * k)) & kWord).to_ullong();
+
+    vector<pair<unsigned char, unsigned char>> ranges;
+    int c = 0;
+    while(c < 256) {
+        if(c % 64 == 0 && words[c / 64] == 0) {
+            c += 64;
+            continue;
+        }
+        if(!this->bytes[c]) {
+            ++c;
+            continue;
+        }
+        int low = c;
+        while(c < 256 && this->bytes[c]) ++c;
+        ranges.push_back({static_cast<unsigned char>(low), static_cast<unsigned char>(c - 1)});
+    }
+    return ranges;
+}
+
+//END OF BYTESET CLASS IMPLEMENTATION
+
+//BEGINNING OF BYTECLASSES CLASS IMPLEMENTATION
+
+ByteClasses::ByteClasses() : count(1) {
+    std::fill(this->classes, this->classes + 256, 0);
+    std::fill(this->representatives, this->representatives + 256, 0);
+}
+
+void ByteClasses::AddRange(unsigned char low, unsigned char high) {
+    if(low > 0) this->boundaries.set(low - 1);
+    this->boundaries.set(high);
+    return;
+}
+
+void ByteClasses::Build(void) {
+    //Every boundary starts a new class with the byte right after it.
+    size_t current = 0;
+    this->representatives[0] = 0;
+    for(int c = 0; c < 256; ++c) {
+        this->classes[c] = static_cast<unsigned char>(current);
+        if(this->boundaries.test(c) && c < 255) {
+            ++current;
+            this->representatives[current] = static_cast<unsigned char>(c + 1);
+        }
+    }
+    this->count = current + 1;
+    return;
+}
+
+size_t ByteClasses::GetCount(void) const {
+    return this->count;
+}
+
+unsigned char ByteClasses::GetRepresentative(size_t a_class) const {
+    return this->representatives[a_class];
+}
+
+//END OF BYTECLASSES CLASS IMPLEMENTATION
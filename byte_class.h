@@ -0,0 +1,85 @@
+#pragma once
+
+/*
+ * Filename: byte_class.h
+ * Programmer: Abdurrahman Alyajouri
+ * Date: 10/17/2026
+ * Purpose: The purpose of this file is to define the ByteSet class, a set of
+ *          input bytes such as the ones a character class matches, and the
+ *          ByteClasses class, which partitions the 256 possible bytes into
+ *          classes of bytes that no transition of an automaton tells apart.
+ *          Table driven engines index their tables by class instead of by
+ *          byte, which keeps the tables small.
+ */
+
+#include <bitset>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+using std::bitset;
+using std::pair;
+using std::size_t;
+using std::vector;
+
+class ByteSet {
+    public:
+        //Ctor, creates an empty set.
+        ByteSet();
+
+        //Insertion.
+        void Add(unsigned char c);
+        void AddRange(unsigned char low, unsigned char high);
+        void AddSet(const ByteSet& a_set);
+
+        //Replaces the set with every byte that is not in it.
+        void Negate(void);
+
+        //Queries.
+        bool Contains(unsigned char c) const;
+        bool IsEmpty(void) const;
+        size_t GetCount(void) const;
+
+        //Returns the smallest byte in the set, which must not be empty.
+        unsigned char GetMin(void) const;
+
+        //Checks if two sets have the same bytes.
+        bool operator==(const ByteSet& a_set) const;
+
+        //Returns the set as a sorted list of disjoint, non adjacent
+        //inclusive ranges.
+        vector<pair<unsigned char, unsigned char>> GetRanges(void) const;
+
+    private:
+        bitset<256> bytes; //Bit c is set if byte c is in the set.
+};
+
+class ByteClasses {
+    public:
+        //Ctor, puts every byte in the same class.
+        ByteClasses();
+
+        //Declares that some transition matches exactly the bytes from "low"
+        //to "high", so they have to be told apart from their neighbours.
+        //Takes effect on the next call to Build.
+        void AddRange(unsigned char low, unsigned char high);
+
+        //Assigns the class numbers. Bytes end up in the same class if every
+        //range added so far either contains both or neither of them.
+        void Build(void);
+
+        //Returns the class of byte "c".
+        unsigned char Get(unsigned char c) const { return this->classes[c]; }
+
+        //Returns the number of classes.
+        size_t GetCount(void) const;
+
+        //Returns some byte that belongs to class "a_class".
+        unsigned char GetRepresentative(size_t a_class) const;
+
+    private:
+        bitset<256> boundaries; //Bit c is set if c and c + 1 differ.
+        unsigned char classes[256]; //Class of each byte.
+        unsigned char representatives[256]; //A byte of each class.
+        size_t count; //Number of classes.
+};
@@ -0,0 +1,799 @@
+/*
+ * Filename: dfa.cpp
+ * Programmer: Abdurrahman Alyajouri
+ * Date: 10/17/2026
+ * Purpose: The purpose of this file is to implement the DFA, DFAView and
+ *          DFAFile classes declared in "dfa.h".
+ */
+
+#include "dfa.h"
+#include "regex.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using std::map;
+using std::string;
+using std::vector;
+
+//Layout of the binary form. Every offset is relative to the start of the
+//header it belongs to, so the bytes can be mapped anywhere. Multi byte
+//values are stored in the byte order of the machine that wrote them, which
+//"byte_order" lets the reader check.
+static const char kDFAMagic[8] = {'R', 'E', 'G', 'X', 'D', 'F', 'A', '\0'};
+static const char kFileMagic[8] = {'R', 'E', 'G', 'X', 'F', 'I', 'L', 'E'};
+static constexpr std::uint32_t kFormatVersion = 1;
+static constexpr std::uint32_t kByteOrder = 0x01020304;
+
+struct DFAHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint32_t state_count;
+    std::uint32_t class_count;
+    std::uint32_t start_state;
+    std::uint32_t dead_state;
+    std::uint64_t classes_offset; //256 bytes, the class of each byte.
+    std::uint64_t table_offset; //state_count * class_count uint32_t.
+    std::uint64_t accepting_offset; //state_count bytes.
+    std::uint64_t pattern_offset;
+    std::uint64_t pattern_length;
+    std::uint64_t size; //Size of the whole DFA, header included.
+};
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint64_t count; //Followed by "count" uint64_t offsets of DFAs.
+};
+
+//Returns true if "length" bytes starting at "offset" fit in "size" bytes.
+static bool FitsWithin(std::uint64_t offset, std::uint64_t length, std::uint64_t size) {
+    return offset <= size && length <= size - offset;
+}
+
+//Rounds "n" up to a multiple of 8.
+static size_t Align8(size_t n) {
+    return (n + 7) & ~static_cast<size_t>(7);
+}
+
+//Runs "input" through the table from "state", stopping early at the dead
+//state. Returns the state it ends in.
+static std::uint32_t Advance(const std::uint32_t* table, const unsigned char* byte_classes,
+                             std::uint32_t class_count, std::uint32_t dead_state,
+                             std::uint32_t state, string_view input) {
+    for(unsigned char c : input) {
+        state = table[static_cast<size_t>(state) * class_count + byte_classes[c]];
+        if(state == dead_state) break;
+    }
+    return state;
+}
+
+//Shared by DFA and DFAView. Runs "input" through the table.
+static bool RunTable(const std::uint32_t* table, const unsigned char* byte_classes,
+                     const unsigned char* accepting, std::uint32_t class_count,
+                     std::uint32_t start_state, std::uint32_t dead_state, string_view input) {
+    return accepting[Advance(table, byte_classes, class_count, dead_state, start_state, input)] != 0;
+}
+
+//Number of inputs RunBatch advances in lockstep, one AVX2 register of
+//32-bit states.
+static constexpr size_t kBatchLanes = 8;
+
+//Shared by DFA and DFAView. Runs every input through the table like
+//RunTable and sets bit i % 64 of "results[i / 64]" if input i matched.
+//Inputs are taken "kBatchLanes" at a time and advanced together, one byte
+//per step, for as long as all of them have bytes left, so the lanes' table
+//lookups don't wait on each other. With AVX2 each step is a pair of
+//gathers, otherwise the lanes are stepped one after the other. What is left
+//of each input is then run on its own.
+static void RunBatch(const std::uint32_t* table, const unsigned char* byte_classes,
+                     const unsigned char* accepting, std::uint32_t state_count,
+                     std::uint32_t class_count, std::uint32_t start_state, std::uint32_t dead_state,
+                     const string_view* inputs, size_t count, std::uint64_t* results) {
+    std::fill(results, results + (count + 63) / 64, 0);
+    if(state_count == 0) return;
+
+#ifdef __AVX2__
+    //Gathers take signed 32-bit indices.
+    bool use_gathers = static_cast<std::uint64_t>(state_count) * class_count <= 0x7FFFFFFF;
+    alignas(32) std::int32_t wide_classes[256];
+    for(int c = 0; c < 256; ++c) wide_classes[c] = byte_classes[c];
+#endif
+
+    size_t i = 0;
+    alignas(32) std::uint32_t states[kBatchLanes];
+    for(; i + kBatchLanes <= count; i += kBatchLanes) {
+        const string_view* batch = inputs + i;
+        const unsigned char* bytes[kBatchLanes];
+        size_t shortest = batch[0].size();
+        for(size_t lane = 0; lane < kBatchLanes; ++lane) {
+            bytes[lane] = reinterpret_cast<const unsigned char*>(batch[lane].data());
+            shortest = std::min(shortest, batch[lane].size());
+        }
+
+        size_t j = 0;
+#ifdef __AVX2__
+        if(use_gathers) {
+            __m256i state = _mm256_set1_epi32(static_cast<int>(start_state));
+            __m256i stride = _mm256_set1_epi32(static_cast<int>(class_count));
+            for(; j < shortest; ++j) {
+                __m256i byte = _mm256_setr_epi32(bytes[0][j], bytes[1][j], bytes[2][j], bytes[3][j],
+                                                 bytes[4][j], bytes[5][j], bytes[6][j], bytes[7][j]);
+                __m256i index = _mm256_add_epi32(_mm256_mullo_epi32(state, stride),
+                                                 _mm256_i32gather_epi32(wide_classes, byte, 4));
+                state = _mm256_i32gather_epi32(reinterpret_cast<const int*>(table), index, 4);
+            }
+            _mm256_store_si256(reinterpret_cast<__m256i*>(states), state);
+        } else
+#endif
+        {
+            std::fill(states, states + kBatchLanes, start_state);
+            for(; j < shortest; ++j)
+                for(size_t lane = 0; lane < kBatchLanes; ++lane)
+                    states[lane] = table[static_cast<size_t>(states[lane]) * class_count + byte_classes[bytes[lane][j]]];
+        }
+
+        for(size_t lane = 0; lane < kBatchLanes; ++lane) {
+            std::uint32_t state = states[lane];
+            for(size_t k = j; k < batch[lane].size() && state != dead_state; ++k)
+                state = table[static_cast<size_t>(state) * class_count + byte_classes[bytes[lane][k]]];
+            if(accepting[state]) results[(i + lane) / 64] |= std::uint64_t(1) << ((i + lane) % 64);
+        }
+    }
+
+    //Fewer than "kBatchLanes" inputs left.
+    for(; i < count; ++i)
+        if(RunTable(table, byte_classes, accepting, class_count, start_state, dead_state, inputs[i]))
+            results[i / 64] |= std::uint64_t(1) << (i % 64);
+    return;
+}
+
+//RunParallel never makes chunks smaller than this, and makes about this
+//many chunks per thread so that stealing can even out slow chunks.
+static constexpr size_t kMinParallelChunk = 64 * 1024;
+static constexpr size_t kChunksPerThread = 4;
+
+//A chunk is run from every state at once, merging the states that reach
+//the same state after every "kMergeInterval" bytes. If more than
+//"kMaxSpeculativeStates" remain after the first merge, the chunk is left
+//for the sequential pass instead.
+static constexpr size_t kMergeInterval = 256;
+static constexpr size_t kMaxSpeculativeStates = 64;
+
+//Running a chunk from every state costs a run of its first block per state.
+//RunParallel only speculates if that is at most 1 / "kSpeculationShare" of
+//the cost of running the whole chunk from one state, since otherwise the
+//threads would do more work between them than a sequential match.
+static constexpr size_t kSpeculationShare = 8;
+
+//Runs "chunk" from every state of the table at once. Writes the state each
+//one ends in to "ends", which has room for "state_count" states. Returns
+//false, leaving "ends" alone, if the states did not converge quickly.
+static bool RunSpeculative(const std::uint32_t* table, const unsigned char* byte_classes,
+                           std::uint32_t state_count, std::uint32_t class_count, std::uint32_t dead_state,
+                           string_view chunk, std::uint32_t* ends) {
+    //"current" holds the distinct live states reached so far. After the
+    //first block, state s has become "current[roots[owners[s]]]", or the
+    //dead state if either index is kDead. "owners" is filled in once, and
+    //later merges only renumber the few "roots", so a block costs the same
+    //no matter how many states the DFA has. States that die are dropped,
+    //since the dead state never leaves itself and would otherwise keep
+    //"current" from shrinking to one.
+    constexpr std::uint32_t kDead = DFA::kNoDeadState;
+    vector<std::uint32_t> current;
+    for(std::uint32_t s = 0; s < state_count; ++s)
+        if(s != dead_state) current.push_back(s);
+
+    vector<std::uint32_t> owners;
+    vector<std::uint32_t> roots;
+    vector<std::uint32_t> slots(state_count, kDead);
+    vector<std::uint32_t> merged;
+    vector<std::uint32_t> remap;
+    for(size_t pos = 0; pos < chunk.size() && !current.empty(); pos += kMergeInterval) {
+        string_view block = chunk.substr(pos, kMergeInterval);
+        for(std::uint32_t& state : current) state = Advance(table, byte_classes, class_count, dead_state, state, block);
+
+        merged.clear();
+        remap.resize(current.size());
+        for(size_t k = 0; k < current.size(); ++k) {
+            if(current[k] == dead_state) {
+                remap[k] = kDead;
+                continue;
+            }
+            std::uint32_t& slot = slots[current[k]];
+            if(slot == kDead) {
+                slot = static_cast<std::uint32_t>(merged.size());
+                merged.push_back(current[k]);
+            }
+            remap[k] = slot;
+        }
+        for(std::uint32_t state : merged) slots[state] = kDead;
+
+        if(pos == 0) {
+            if(merged.size() > kMaxSpeculativeStates) return false;
+            owners.assign(state_count, kDead);
+            for(std::uint32_t s = 0, k = 0; s < state_count; ++s)
+                if(s != dead_state) owners[s] = remap[k++];
+            roots.resize(merged.size());
+            for(size_t k = 0; k < roots.size(); ++k) roots[k] = static_cast<std::uint32_t>(k);
+        } else if(merged.size() != current.size()) {
+            //Nothing merged or died otherwise, and "remap" is the identity.
+            for(std::uint32_t& root : roots)
+                if(root != kDead) root = remap[root];
+        }
+        current.swap(merged);
+    }
+
+    for(std::uint32_t s = 0; s < state_count; ++s) {
+        if(owners.empty()) ends[s] = s;
+        else if(owners[s] == kDead || roots[owners[s]] == kDead) ends[s] = dead_state;
+        else ends[s] = current[roots[owners[s]]];
+    }
+    return true;
+}
+
+//Shared by DFA and DFAView. Matches "input" like RunTable, splitting it
+//into chunks that are run on "pool" at the same time. The first chunk is
+//run from the start state. Every other chunk doesn't know what state it
+//will start in yet, so it is run from all states at once, which usually
+//collapses to a few states within a few hundred bytes. The resulting maps
+//from starting to ending state are then chained together in order, with
+//any chunk whose states didn't collapse run there and then.
+static bool RunParallel(const std::uint32_t* table, const unsigned char* byte_classes,
+                        const unsigned char* accepting, std::uint32_t state_count,
+                        std::uint32_t class_count, std::uint32_t start_state, std::uint32_t dead_state,
+                        string_view input, ThreadPool& pool) {
+    size_t chunk_count = std::min(input.size() / kMinParallelChunk, pool.GetThreadCount() * kChunksPerThread);
+    if(chunk_count < 2) return RunTable(table, byte_classes, accepting, class_count, start_state, dead_state, input);
+    size_t chunk_size = (input.size() + chunk_count - 1) / chunk_count;
+    if(static_cast<std::uint64_t>(state_count) * kMergeInterval * kSpeculationShare > chunk_size)
+        return RunTable(table, byte_classes, accepting, class_count, start_state, dead_state, input);
+
+    vector<std::uint32_t> ends((chunk_count - 1) * static_cast<size_t>(state_count));
+    vector<unsigned char> resolved(chunk_count, 0);
+    std::uint32_t state = start_state;
+    pool.Run(chunk_count, [&](size_t c) {
+        string_view chunk = input.substr(c * chunk_size, chunk_size);
+        if(c == 0) {
+            state = Advance(table, byte_classes, class_count, dead_state, start_state, chunk);
+        } else {
+            std::uint32_t* chunk_ends = &ends[(c - 1) * static_cast<size_t>(state_count)];
+            resolved[c] = RunSpeculative(table, byte_classes, state_count, class_count, dead_state, chunk, chunk_ends);
+        }
+    });
+
+    for(size_t c = 1; c < chunk_count && state != dead_state; ++c) {
+        if(resolved[c]) state = ends[(c - 1) * static_cast<size_t>(state_count) + state];
+        else state = Advance(table, byte_classes, class_count, dead_state, state, input.substr(c * chunk_size, chunk_size));
+    }
+    return accepting[state] != 0;
+}
+
+//BEGINNING OF DFA CLASS IMPLEMENTATION
+
+DFA::DFA() : state_count(0), class_count(1), start_state(0), dead_state(kNoDeadState) {
+    std::fill(this->byte_classes, this->byte_classes + 256, 0);
+}
+
+DFA::DFA(const Regex& a_regex, size_t max_states) : DFA() {
+    this->pattern = a_regex.pattern;
+    DoSubsetConstruction(a_regex.program->nfa, a_regex.program->byte_classes, max_states);
+    Minimize();
+    FindDeadState();
+}
+
+const string& DFA::GetPattern(void) const {
+    return this->pattern;
+}
+
+bool DFA::Match(string_view input) const {
+    if(this->state_count == 0) return false;
+    return RunTable(this->table.data(), this->byte_classes, this->accepting.data(),
+                    this->class_count, this->start_state, this->dead_state, input);
+}
+
+bool DFA::MatchParallel(string_view input, ThreadPool& pool) const {
+    if(this->state_count == 0) return false;
+    return RunParallel(this->table.data(), this->byte_classes, this->accepting.data(), this->state_count,
+                       this->class_count, this->start_state, this->dead_state, input, pool);
+}
+
+void DFA::MatchBatch(const string_view* inputs, size_t count, std::uint64_t* results) const {
+    RunBatch(this->table.data(), this->byte_classes, this->accepting.data(), this->state_count,
+             this->class_count, this->start_state, this->dead_state, inputs, count, results);
+    return;
+}
+
+vector<std::uint64_t> DFA::MatchBatch(const vector<string_view>& inputs) const {
+    vector<std::uint64_t> results((inputs.size() + 63) / 64);
+    MatchBatch(inputs.data(), inputs.size(), results.data());
+    return results;
+}
+
+std::uint32_t DFA::GetStateCount(void) const {
+    return this->state_count;
+}
+
+std::uint32_t DFA::GetClassCount(void) const {
+    return this->class_count;
+}
+
+std::uint32_t DFA::GetStartState(void) const {
+    return this->start_state;
+}
+
+const std::uint32_t* DFA::GetTable(void) const {
+    return this->table.data();
+}
+
+bool DFA::IsAccepting(std::uint32_t state) const {
+    return this->accepting[state] != 0;
+}
+
+const unsigned char* DFA::GetByteClasses(void) const {
+    return this->byte_classes;
+}
+
+std::uint32_t DFA::GetDeadState(void) const {
+    return this->dead_state;
+}
+
+void DFA::Serialize(string& out) const {
+    out.resize(Align8(out.size()), '\0');
+    size_t base = out.size();
+
+    //Lay the sections out behind the header, keeping the table aligned.
+    DFAHeader header;
+    std::memcpy(header.magic, kDFAMagic, sizeof(header.magic));
+    header.version = kFormatVersion;
+    header.byte_order = kByteOrder;
+    header.state_count = this->state_count;
+    header.class_count = this->class_count;
+    header.start_state = this->start_state;
+    header.dead_state = this->dead_state;
+    header.classes_offset = Align8(sizeof(DFAHeader));
+    header.table_offset = Align8(header.classes_offset + 256);
+    header.accepting_offset = header.table_offset + this->table.size() * sizeof(std::uint32_t);
+    header.pattern_offset = header.accepting_offset + this->accepting.size();
+    header.pattern_length = this->pattern.size();
+    header.size = Align8(header.pattern_offset + header.pattern_length);
+
+    out.resize(base + header.size, '\0');
+    char* dest = &out[base];
+    std::memcpy(dest, &header, sizeof(header));
+    std::memcpy(dest + header.classes_offset, this->byte_classes, 256);
+    std::memcpy(dest + header.table_offset, this->table.data(), this->table.size() * sizeof(std::uint32_t));
+    std::memcpy(dest + header.accepting_offset, this->accepting.data(), this->accepting.size());
+    std::memcpy(dest + header.pattern_offset, this->pattern.data(), this->pattern.size());
+    return;
+}
+
+void DFA::DoSubsetConstruction(const TNFA& nfa, const ByteClasses& classes, size_t max_states) {
+    this->class_count = static_cast<std::uint32_t>(classes.GetCount());
+    for(int c = 0; c < 256; ++c) this->byte_classes[c] = classes.Get(static_cast<unsigned char>(c));
+    if(nfa.IsEmpty()) return;
+
+    //Each DFA state stands for the sorted set of NFA states that can
+    //consume a symbol or accept, after following epsilon transitions.
+    map<vector<StateId>, std::uint32_t> state_map;
+    vector<vector<StateId>> sets;
+    vector<std::uint32_t> marks(nfa.GetStateCount(), 0);
+    std::uint32_t generation = 0;
+    vector<StateId> pending;
+
+    //Returns the DFA state for the closure of the states in "pending",
+    //adding it if it is new.
+    auto add_state = [&](void) -> std::uint32_t {
+        ++generation;
+        vector<StateId> set;
+        size_t seed_count = 0;
+        for(StateId id : pending) {
+            if(marks[id] == generation) continue;
+            marks[id] = generation;
+            pending[seed_count++] = id;
+        }
+        pending.resize(seed_count);
+        while(!pending.empty()) {
+            const State& state = nfa.GetState(pending.back());
+            StateId id = pending.back();
+            pending.pop_back();
+            if(state.HasSymbolTransition() || state.acceptance) set.push_back(id);
+            for(int i = 0; i < state.epsilon_count; ++i) {
+                StateId next_state = state.epsilon_transitions[i];
+                if(marks[next_state] != generation) {
+                    marks[next_state] = generation;
+                    pending.push_back(next_state);
+                }
+            }
+        }
+        std::sort(set.begin(), set.end());
+
+        auto found = state_map.find(set);
+        if(found != state_map.end()) return found->second;
+        if(sets.size() >= max_states) throw std::length_error("DFA needs too many states.");
+
+        std::uint32_t index = static_cast<std::uint32_t>(sets.size());
+        bool is_accepting = false;
+        for(StateId id : set)
+            if(nfa.GetState(id).acceptance) is_accepting = true;
+        state_map.insert({set, index});
+        sets.push_back(std::move(set));
+        this->accepting.push_back(is_accepting ? 1 : 0);
+        this->table.resize(this->table.size() + this->class_count, 0);
+        return index;
+    };
+
+    pending.assign(1, nfa.GetStartState());
+    this->start_state = add_state();
+
+    //Visit states in the order they were found, filling in their rows.
+    for(size_t from = 0; from < sets.size(); ++from) {
+        for(std::uint32_t k = 0; k < this->class_count; ++k) {
+            char c = static_cast<char>(classes.GetRepresentative(k));
+            pending.clear();
+            for(StateId id : sets[from]) {
+                const State& state = nfa.GetState(id);
+                if(state.Matches(c)) pending.push_back(state.symbol_transition);
+            }
+            std::uint32_t to = add_state();
+            this->table[from * this->class_count + k] = to;
+        }
+    }
+
+    this->state_count = static_cast<std::uint32_t>(sets.size());
+    return;
+}
+
+void DFA::Minimize(void) {
+    std::uint32_t n = this->state_count;
+    std::uint32_t k_count = this->class_count;
+    if(n == 0) return;
+
+    //Predecessors of every state on every class, in compressed rows:
+    //the predecessors of s on class k are
+    //"predecessors[offsets[k * n + s] .. offsets[k * n + s + 1]]".
+    vector<std::uint32_t> offsets(static_cast<size_t>(k_count) * n + 1, 0);
+    for(std::uint32_t s = 0; s < n; ++s)
+        for(std::uint32_t k = 0; k < k_count; ++k)
+            ++offsets[static_cast<size_t>(k) * n + this->table[static_cast<size_t>(s) * k_count + k] + 1];
+    for(size_t i = 1; i < offsets.size(); ++i) offsets[i] += offsets[i - 1];
+    vector<std::uint32_t> predecessors(offsets.back());
+    vector<std::uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for(std::uint32_t s = 0; s < n; ++s)
+        for(std::uint32_t k = 0; k < k_count; ++k)
+            predecessors[fill[static_cast<size_t>(k) * n + this->table[static_cast<size_t>(s) * k_count + k]]++] = s;
+
+    //The partition. Block b holds "elements[begin[b] .. end[b]]", and the
+    //states of a block that were marked while splitting are moved to the
+    //front of it, up to "marked_end[b]".
+    vector<std::uint32_t> elements(n), location(n), block_of(n);
+    vector<std::uint32_t> begin, end, marked_end;
+
+    //Start with the accepting and non accepting states apart.
+    std::uint32_t next_index = 0;
+    for(int pass = 1; pass >= 0; --pass) {
+        std::uint32_t block_begin = next_index;
+        for(std::uint32_t s = 0; s < n; ++s) {
+            if(this->accepting[s] != pass) continue;
+            elements[next_index] = s;
+            location[s] = next_index++;
+            block_of[s] = static_cast<std::uint32_t>(begin.size());
+        }
+        if(next_index == block_begin) continue;
+        begin.push_back(block_begin);
+        end.push_back(next_index);
+        marked_end.push_back(block_begin);
+    }
+
+    //Blocks still to split others with.
+    vector<std::uint32_t> worklist;
+    vector<bool> in_worklist;
+    for(std::uint32_t b = 0; b < begin.size(); ++b) {
+        worklist.push_back(b);
+        in_worklist.push_back(true);
+    }
+
+    vector<std::uint32_t> splitter;
+    vector<std::uint32_t> touched;
+    while(!worklist.empty()) {
+        std::uint32_t a = worklist.back();
+        worklist.pop_back();
+        in_worklist[a] = false;
+        splitter.assign(elements.begin() + begin[a], elements.begin() + end[a]);
+
+        for(std::uint32_t k = 0; k < k_count; ++k) {
+            //Mark every state with a transition on class k into the
+            //splitter.
+            touched.clear();
+            for(std::uint32_t s : splitter) {
+                size_t row = static_cast<size_t>(k) * n + s;
+                for(std::uint32_t i = offsets[row]; i < offsets[row + 1]; ++i) {
+                    std::uint32_t p = predecessors[i];
+                    std::uint32_t b = block_of[p];
+                    if(location[p] < marked_end[b]) continue;
+                    if(marked_end[b] == begin[b]) touched.push_back(b);
+                    std::uint32_t swap_with = elements[marked_end[b]];
+                    std::swap(elements[location[p]], elements[marked_end[b]]);
+                    location[swap_with] = location[p];
+                    location[p] = marked_end[b]++;
+                }
+            }
+
+            //Split the blocks that were only partly marked.
+            for(std::uint32_t b : touched) {
+                if(marked_end[b] == end[b]) {
+                    marked_end[b] = begin[b];
+                    continue;
+                }
+                std::uint32_t new_block = static_cast<std::uint32_t>(begin.size());
+                begin.push_back(begin[b]);
+                end.push_back(marked_end[b]);
+                marked_end.push_back(begin[b]);
+                begin[b] = marked_end[b];
+                marked_end[b] = begin[b];
+                for(std::uint32_t i = begin[new_block]; i < end[new_block]; ++i)
+                    block_of[elements[i]] = new_block;
+
+                //Hopcroft's trick: only the smaller half has to be used as
+                //a splitter, unless the block was going to be used anyway.
+                in_worklist.push_back(false);
+                if(in_worklist[b]) {
+                    worklist.push_back(new_block);
+                    in_worklist[new_block] = true;
+                } else {
+                    std::uint32_t smaller = end[new_block] - begin[new_block] < end[b] - begin[b] ? new_block : b;
+                    worklist.push_back(smaller);
+                    in_worklist[smaller] = true;
+                }
+            }
+        }
+    }
+
+    //Every block becomes a state.
+    std::uint32_t block_count = static_cast<std::uint32_t>(begin.size());
+    vector<std::uint32_t> new_table(static_cast<size_t>(block_count) * k_count);
+    vector<unsigned char> new_accepting(block_count);
+    for(std::uint32_t b = 0; b < block_count; ++b) {
+        std::uint32_t representative = elements[begin[b]];
+        new_accepting[b] = this->accepting[representative];
+        for(std::uint32_t k = 0; k < k_count; ++k)
+            new_table[static_cast<size_t>(b) * k_count + k] =
+                block_of[this->table[static_cast<size_t>(representative) * k_count + k]];
+    }
+
+    this->start_state = block_of[this->start_state];
+    this->state_count = block_count;
+    this->table.swap(new_table);
+    this->accepting.swap(new_accepting);
+    return;
+}
+
+void DFA::FindDeadState(void) {
+    //After minimization, at most one state can't reach acceptance, and
+    //every transition out of it leads back to it.
+    this->dead_state = kNoDeadState;
+    for(std::uint32_t s = 0; s < this->state_count; ++s) {
+        if(this->accepting[s]) continue;
+        bool loops = true;
+        for(std::uint32_t k = 0; k < this->class_count && loops; ++k)
+            loops = this->table[static_cast<size_t>(s) * this->class_count + k] == s;
+        if(loops) {
+            this->dead_state = s;
+            break;
+        }
+    }
+    return;
+}
+
+//END OF DFA CLASS IMPLEMENTATION
+
+//BEGINNING OF DFAVIEW CLASS IMPLEMENTATION
+
+DFAView::DFAView()
+    : state_count(0), class_count(0), start_state(0), dead_state(DFA::kNoDeadState),
+      byte_classes(nullptr), table(nullptr), accepting(nullptr) {}
+
+bool DFAView::Load(const void* data, size_t size) {
+    *this = DFAView();
+    const char* bytes = static_cast<const char*>(data);
+    if(size < sizeof(DFAHeader) || reinterpret_cast<std::uintptr_t>(bytes) % 8 != 0) return false;
+
+    DFAHeader header;
+    std::memcpy(&header, bytes, sizeof(header));
+    if(std::memcmp(header.magic, kDFAMagic, sizeof(header.magic)) != 0) return false;
+    if(header.version != kFormatVersion || header.byte_order != kByteOrder) return false;
+
+    //Make sure every section lies within the buffer, comparing lengths
+    //against what is left after each offset so a huge offset can't wrap
+    //the sum around.
+    std::uint64_t table_size = static_cast<std::uint64_t>(header.state_count) * header.class_count * sizeof(std::uint32_t);
+    if(header.size > size || header.class_count == 0 || header.class_count > 256 ||
+       header.state_count == 0 || header.start_state >= header.state_count ||
+       (header.dead_state >= header.state_count && header.dead_state != DFA::kNoDeadState) ||
+       !FitsWithin(header.classes_offset, 256, header.size) || header.table_offset % 4 != 0 ||
+       !FitsWithin(header.table_offset, table_size, header.size) ||
+       !FitsWithin(header.accepting_offset, header.state_count, header.size) ||
+       !FitsWithin(header.pattern_offset, header.pattern_length, header.size))
+        return false;
+
+    //Matching follows the table without bounds checks, so every class and
+    //every transition has to be in range. One pass over them costs little
+    //next to mapping the file.
+    const unsigned char* classes = reinterpret_cast<const unsigned char*>(bytes + header.classes_offset);
+    for(int c = 0; c < 256; ++c)
+        if(classes[c] >= header.class_count) return false;
+    const std::uint32_t* entries = reinterpret_cast<const std::uint32_t*>(bytes + header.table_offset);
+    std::uint64_t entry_count = static_cast<std::uint64_t>(header.state_count) * header.class_count;
+    std::uint32_t largest = 0;
+    for(std::uint64_t i = 0; i < entry_count; ++i) largest = std::max(largest, entries[i]);
+    if(largest >= header.state_count) return false;
+
+    this->pattern = string_view(bytes + header.pattern_offset, header.pattern_length);
+    this->state_count = header.state_count;
+    this->class_count = header.class_count;
+    this->start_state = header.start_state;
+    this->dead_state = header.dead_state;
+    this->byte_classes = classes;
+    this->table = entries;
+    this->accepting = reinterpret_cast<const unsigned char*>(bytes + header.accepting_offset);
+    return true;
+}
+
+string_view DFAView::GetPattern(void) const {
+    return this->pattern;
+}
+
+bool DFAView::Match(string_view input) const {
+    if(!this->table) return false;
+    return RunTable(this->table, this->byte_classes, this->accepting, this->class_count,
+                    this->start_state, this->dead_state, input);
+}
+
+bool DFAView::MatchParallel(string_view input, ThreadPool& pool) const {
+    if(this->state_count == 0) return false;
+    return RunParallel(this->table, this->byte_classes, this->accepting, this->state_count, this->class_count,
+                       this->start_state, this->dead_state, input, pool);
+}
+
+void DFAView::MatchBatch(const string_view* inputs, size_t count, std::uint64_t* results) const {
+    RunBatch(this->table, this->byte_classes, this->accepting, this->state_count, this->class_count,
+             this->start_state, this->dead_state, inputs, count, results);
+    return;
+}
+
+vector<std::uint64_t> DFAView::MatchBatch(const vector<string_view>& inputs) const {
+    vector<std::uint64_t> results((inputs.size() + 63) / 64);
+    MatchBatch(inputs.data(), inputs.size(), results.data());
+    return results;
+}
+
+std::uint32_t DFAView::GetStateCount(void) const {
+    return this->state_count;
+}
+
+std::uint32_t DFAView::GetClassCount(void) const {
+    return this->class_count;
+}
+
+std::uint32_t DFAView::GetStartState(void) const {
+    return this->start_state;
+}
+
+const std::uint32_t* DFAView::GetTable(void) const {
+    return this->table;
+}
+
+bool DFAView::IsAccepting(std::uint32_t state) const {
+    return this->accepting[state] != 0;
+}
+
+const unsigned char* DFAView::GetByteClasses(void) const {
+    return this->byte_classes;
+}
+
+std::uint32_t DFAView::GetDeadState(void) const {
+    return this->dead_state;
+}
+
+//END OF DFAVIEW CLASS IMPLEMENTATION
+
+//BEGINNING OF DFAFILE CLASS IMPLEMENTATION
+
+DFAFile::DFAFile() : data(nullptr), size(0) {}
+
+DFAFile::~DFAFile() {
+    Close();
+}
+
+bool DFAFile::Open(const string& path) {
+    Close();
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0) return false;
+    struct stat info;
+    if(fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(FileHeader)) {
+        close(fd);
+        return false;
+    }
+    this->size = static_cast<size_t>(info.st_size);
+    this->data = mmap(nullptr, this->size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(this->data == MAP_FAILED) {
+        this->data = nullptr;
+        return false;
+    }
+
+    const char* bytes = static_cast<const char*>(this->data);
+    FileHeader header;
+    std::memcpy(&header, bytes, sizeof(header));
+    bool valid = std::memcmp(header.magic, kFileMagic, sizeof(header.magic)) == 0 &&
+                 header.version == kFormatVersion && header.byte_order == kByteOrder &&
+                 header.count <= (this->size - sizeof(FileHeader)) / sizeof(std::uint64_t);
+
+    //Every offset in the directory must point at a valid DFA.
+    for(std::uint64_t i = 0; valid && i < header.count; ++i) {
+        std::uint64_t offset;
+        std::memcpy(&offset, bytes + sizeof(FileHeader) + i * sizeof(std::uint64_t), sizeof(offset));
+        DFAView view;
+        valid = offset < this->size && view.Load(bytes + offset, this->size - offset);
+        this->views.push_back(view);
+    }
+
+    if(!valid) Close();
+    return valid;
+}
+
+void DFAFile::Close(void) {
+    if(this->data) munmap(this->data, this->size);
+    this->data = nullptr;
+    this->size = 0;
+    this->views.clear();
+    return;
+}
+
+size_t DFAFile::GetCount(void) const {
+    return this->views.size();
+}
+
+const DFAView& DFAFile::GetDFA(size_t i) const {
+    return this->views[i];
+}
+
+bool DFAFile::Write(const string& path, const vector<DFA>& dfas) {
+    //Header and directory first, then the DFAs, each 8 byte aligned.
+    string out(sizeof(FileHeader) + dfas.size() * sizeof(std::uint64_t), '\0');
+    FileHeader header;
+    std::memcpy(header.magic, kFileMagic, sizeof(header.magic));
+    header.version = kFormatVersion;
+    header.byte_order = kByteOrder;
+    header.count = dfas.size();
+    std::memcpy(&out[0], &header, sizeof(header));
+
+    for(size_t i = 0; i < dfas.size(); ++i) {
+        //Serialize pads to 8 bytes before appending.
+        std::uint64_t offset = Align8(out.size());
+        std::memcpy(&out[sizeof(FileHeader) + i * sizeof(std::uint64_t)], &offset, sizeof(offset));
+        dfas[i].Serialize(out);
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(out.data(), static_cast<std::streamsize>(out.size()));
+    return static_cast<bool>(file);
+}
+
+//END OF DFAFILE CLASS IMPLEMENTATION
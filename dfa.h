@@ -0,0 +1,181 @@
+#pragma once
+
+/*
+ * Filename: dfa.h
+ * Programmer: Abdurrahman Alyajouri
+ * Date: 10/17/2026
+ * Purpose: The purpose of this file is to define the DFA class, a fully
+ *          determinized and minimized automaton built ahead of time from a
+ *          Regex, along with its binary format. A serialized DFA is
+ *          position independent, so it can be memory mapped and matched
+ *          against in place by a DFAView, with no deserialization step.
+ */
+
+#include "byte_class.h"
+#include "thread_pool.h"
+#include "tnfa.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using std::size_t;
+using std::string;
+using std::string_view;
+using std::vector;
+
+class Regex;
+
+class DFA {
+    public:
+        //Default limit on the number of states the subset construction may
+        //build before giving up.
+        static constexpr size_t kDefaultMaxStates = 10000;
+
+        //Ctors. Building from a Regex runs the subset construction on its
+        //NFA and minimizes the result with Hopcroft's algorithm. Throws
+        //std::length_error if the DFA would need more than "max_states"
+        //states.
+        DFA();
+        DFA(const Regex& a_regex, size_t max_states = kDefaultMaxStates);
+
+        //Returns the pattern the DFA was built from.
+        const string& GetPattern(void) const;
+
+        //Checks if the whole input is matched, like Regex::Match.
+        bool Match(string_view input) const;
+
+        //Matches one large input like Match, splitting it into chunks
+        //that are run on the threads of "pool" at the same time. Inputs
+        //too small to be worth splitting, and DFAs with too many states to
+        //run every chunk from all of them cheaply, are matched on the
+        //calling thread.
+        bool MatchParallel(string_view input, ThreadPool& pool) const;
+
+        //Matches each of "count" inputs like Match, several at a time.
+        //Writes a bitmap of the results: bit i % 64 of "results[i / 64]"
+        //is set if "inputs[i]" matched. "results" must have room for
+        //(count + 63) / 64 words. Built with AVX2, the inputs are advanced
+        //with vector gathers.
+        void MatchBatch(const string_view* inputs, size_t count, std::uint64_t* results) const;
+        vector<std::uint64_t> MatchBatch(const vector<string_view>& inputs) const;
+
+        //Getters for the table. The transition of state s on a byte of
+        //class k is "GetTable()[s * GetClassCount() + k]".
+        std::uint32_t GetStateCount(void) const;
+        std::uint32_t GetClassCount(void) const;
+        std::uint32_t GetStartState(void) const;
+        const std::uint32_t* GetTable(void) const;
+        bool IsAccepting(std::uint32_t state) const;
+        const unsigned char* GetByteClasses(void) const;
+
+        //Returns the state that can never reach an accepting state, or
+        //kNoDeadState if there is none.
+        static constexpr std::uint32_t kNoDeadState = 0xFFFFFFFF;
+        std::uint32_t GetDeadState(void) const;
+
+        //Appends the binary form of the DFA to "out", padding "out" to a
+        //multiple of 8 bytes first so the tables stay aligned.
+        void Serialize(string& out) const;
+
+    private:
+        //Determinizes "nfa" by exploring every reachable set of states.
+        void DoSubsetConstruction(const TNFA& nfa, const ByteClasses& classes, size_t max_states);
+
+        //Merges equivalent states with Hopcroft's partition refinement.
+        void Minimize(void);
+
+        //Finds the state that can never reach an accepting state.
+        void FindDeadState(void);
+
+        string pattern; //The pattern the DFA was built from.
+
+        std::uint32_t state_count;
+        std::uint32_t class_count;
+        std::uint32_t start_state;
+        std::uint32_t dead_state;
+
+        unsigned char byte_classes[256]; //Class of each byte.
+        vector<std::uint32_t> table; //Transitions, one row per state.
+        vector<unsigned char> accepting; //1 for accepting states.
+};
+
+//A read only DFA over a buffer holding its binary form, such as a memory
+//mapped file. The buffer must outlive the view.
+class DFAView {
+    public:
+        //Ctor, creates an empty view that matches nothing.
+        DFAView();
+
+        //Points the view at the DFA serialized at "data". Returns false,
+        //leaving the view empty, if the buffer does not hold a valid DFA
+        //of this version. Every section must lie within the buffer and
+        //every byte class and transition must be in range, which takes one
+        //pass over the table.
+        bool Load(const void* data, size_t size);
+
+        //Returns the pattern the DFA was built from.
+        string_view GetPattern(void) const;
+
+        //Checks if the whole input is matched, like Regex::Match.
+        bool Match(string_view input) const;
+
+        //Matches one large input on many threads, same as DFA's.
+        bool MatchParallel(string_view input, ThreadPool& pool) const;
+
+        //Matches many inputs at a time, same as DFA's.
+        void MatchBatch(const string_view* inputs, size_t count, std::uint64_t* results) const;
+        vector<std::uint64_t> MatchBatch(const vector<string_view>& inputs) const;
+
+        //Getters for the table, same as DFA's.
+        std::uint32_t GetStateCount(void) const;
+        std::uint32_t GetClassCount(void) const;
+        std::uint32_t GetStartState(void) const;
+        const std::uint32_t* GetTable(void) const;
+        bool IsAccepting(std::uint32_t state) const;
+        const unsigned char* GetByteClasses(void) const;
+        std::uint32_t GetDeadState(void) const;
+
+    private:
+        string_view pattern;
+        std::uint32_t state_count;
+        std::uint32_t class_count;
+        std::uint32_t start_state;
+        std::uint32_t dead_state;
+        const unsigned char* byte_classes;
+        const std::uint32_t* table;
+        const unsigned char* accepting;
+};
+
+//A file holding any number of serialized DFAs, such as the one written by
+//the dfa_compile tool, memory mapped read only. Many processes mapping the
+//same file share its pages.
+class DFAFile {
+    public:
+        //Ctor and dtor. The dtor unmaps the file.
+        DFAFile();
+        ~DFAFile();
+        DFAFile(const DFAFile&) = delete;
+        DFAFile& operator=(const DFAFile&) = delete;
+
+        //Maps the file at "path" and checks every DFA in it. Returns false
+        //if the file can't be mapped or is not a valid DFA file.
+        bool Open(const string& path);
+
+        //Unmaps the file.
+        void Close(void);
+
+        //Returns the number of DFAs in the file and the view of DFA "i".
+        size_t GetCount(void) const;
+        const DFAView& GetDFA(size_t i) const;
+
+        //Writes "dfas" to "path" in the format Open reads. Returns false if
+        //the file could not be written.
+        static bool Write(const string& path, const vector<DFA>& dfas);
+
+    private:
+        void* data; //Start of the mapping, or nullptr.
+        size_t size; //Length of the mapping.
+        vector<DFAView> views; //One per DFA in the file.
+};
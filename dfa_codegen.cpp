@@ -0,0 +1,267 @@
+/*
+ * Filename: dfa_codegen.cpp
+ * Programmer: Abdurrahman Alyajouri
+ * Date: 10/17/2026
+ * Purpose: The purpose of this file is to implement the DFACodeGenerator
+ *          class declared in "dfa_codegen.h".
+ */
+
+#include "dfa_codegen.h"
+#include <cctype>
+#include <cstdio>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using std::pair;
+using std::queue;
+using std::string;
+using std::vector;
+
+//Returns a C++ expression for byte "c", a character literal if it is a
+//letter or digit and a hex number otherwise.
+static string GetByteLiteral(unsigned char c) {
+    if(std::isalnum(c)) return string("'") + static_cast<char>(c) + "'";
+    char buffer[8];
+    std::snprintf(buffer, sizeof(buffer), "0x%02X", c);
+    return buffer;
+}
+
+//Returns the label of "state".
+static string GetLabel(std::uint32_t state) {
+    return "s" + std::to_string(state);
+}
+
+//Returns "text" with everything but printable ASCII escaped, so it can go
+//in a comment.
+static string Escape(const string& text) {
+    string escaped;
+    for(unsigned char c : text) {
+        if(c >= 0x20 && c < 0x7F) {
+            escaped += static_cast<char>(c);
+            continue;
+        }
+        char buffer[8];
+        std::snprintf(buffer, sizeof(buffer), "\\x%02X", c);
+        escaped += buffer;
+    }
+    return escaped;
+}
+
+//Returns a condition that is true if byte "c" falls in one of "ranges".
+static string GetScalarTest(const string& c, const vector<pair<unsigned char, unsigned char>>& ranges) {
+    string test;
+    for(size_t i = 0; i < ranges.size(); ++i) {
+        if(i > 0) test += " || ";
+        unsigned char low = ranges[i].first, high = ranges[i].second;
+        if(low == high) test += c + " == " + GetByteLiteral(low);
+        else if(low == 0) test += c + " <= " + GetByteLiteral(high);
+        else if(high == 0xFF) test += c + " >= " + GetByteLiteral(low);
+        else test += "(" + c + " >= " + GetByteLiteral(low) + " && " + c + " <= " + GetByteLiteral(high) + ")";
+    }
+    return test;
+}
+
+//Returns an SSE2 expression with 0xFF in every lane of "v" that falls in
+//one of "ranges". A byte is in [low, high] if subtracting "low" wraps it to
+//at most "high - low", which a saturating subtraction turns into 0.
+static string GetVectorTest(const vector<pair<unsigned char, unsigned char>>& ranges) {
+    string test;
+    for(size_t i = 0; i < ranges.size(); ++i) {
+        unsigned char low = ranges[i].first, high = ranges[i].second;
+        string in_range;
+        if(low == high) {
+            in_range = "_mm_cmpeq_epi8(v, _mm_set1_epi8(static_cast<char>(" + GetByteLiteral(low) + ")))";
+        } else {
+            string shifted = low == 0 ? string("v") : "_mm_sub_epi8(v, _mm_set1_epi8(static_cast<char>(" + GetByteLiteral(low) + ")))";
+            in_range = "_mm_cmpeq_epi8(_mm_subs_epu8(" + shifted + ", _mm_set1_epi8(static_cast<char>(" +
+                       GetByteLiteral(static_cast<unsigned char>(high - low)) + "))), _mm_setzero_si128())";
+        }
+        test = i == 0 ? in_range : "_mm_or_si128(" + test + ", " + in_range + ")";
+    }
+    return test;
+}
+
+//BEGINNING OF DFACODEGENERATOR CLASS IMPLEMENTATION
+
+DFACodeGenerator::DFACodeGenerator(const DFA& a_dfa, const string& function_name)
+    : dfa(a_dfa), function_name(function_name) {
+    bool valid = !function_name.empty() && !std::isdigit(static_cast<unsigned char>(function_name[0]));
+    for(unsigned char c : function_name) valid = valid && (std::isalnum(c) || c == '_');
+    if(!valid) throw std::invalid_argument("\"" + function_name + "\" is not a valid function name.");
+}
+
+string DFACodeGenerator::GenerateHeader(void) const {
+    string out;
+    out += "#pragma once\n\n";
+    out += "//Generated by DFACodeGenerator from the pattern \"" + Escape(this->dfa.GetPattern()) + "\".\n\n";
+    out += "#include <cstddef>\n#include <string_view>\n\n";
+    out += "//Checks if the whole input is matched by the pattern.\n";
+    out += "bool " + this->function_name + "(const char* data, std::size_t size);\n";
+    out += "bool " + this->function_name + "(std::string_view input);\n";
+    return out;
+}
+
+string DFACodeGenerator::GenerateSource(void) const {
+    //Lay the states out in the order a breadth first walk from the start
+    //state reaches them, leaving the dead state out, since jumping to it
+    //just returns false.
+    std::uint32_t state_count = this->dfa.GetStateCount();
+    std::uint32_t dead = this->dfa.GetDeadState();
+    vector<std::uint32_t> order;
+    vector<bool> seen(state_count, false);
+    vector<bool> targeted(state_count, false);
+    if(state_count > 0 && this->dfa.GetStartState() != dead) {
+        queue<std::uint32_t> pending;
+        pending.push(this->dfa.GetStartState());
+        seen[this->dfa.GetStartState()] = true;
+        while(!pending.empty()) {
+            std::uint32_t s = pending.front();
+            pending.pop();
+            order.push_back(s);
+            vector<Range> ranges = GetRanges(s);
+            for(const Range& range : ranges) {
+                if(range.target == dead || (ranges.size() == 1 && range.target == s)) continue;
+                targeted[range.target] = true;
+                if(!seen[range.target]) {
+                    seen[range.target] = true;
+                    pending.push(range.target);
+                }
+            }
+        }
+    }
+
+    string body;
+    for(std::uint32_t s : order) EmitState(body, s, targeted[s]);
+    bool uses_vectors = body.find("_mm_") != string::npos;
+    bool reads_input = body.find("p == end") != string::npos;
+    bool reads_bytes = body.find("c = *p++;") != string::npos;
+
+    string out;
+    out += "//Generated by DFACodeGenerator from the pattern \"" + Escape(this->dfa.GetPattern()) + "\".\n";
+    out += "//" + std::to_string(state_count) + " states. Regenerate it instead of editing it.\n\n";
+    out += "#include <cstddef>\n#include <string_view>\n\n";
+    if(uses_vectors) {
+        out += "#if defined(__SSE2__) && defined(__GNUC__)\n";
+        out += "#include <emmintrin.h>\n";
+        out += "#define DFA_CODEGEN_SSE2 1\n";
+        out += "#endif\n\n";
+    }
+    out += "bool " + this->function_name + "(const char* data, std::size_t size) {\n";
+    if(reads_input) {
+        out += "    const unsigned char* p = reinterpret_cast<const unsigned char*>(data);\n";
+        out += "    const unsigned char* const end = p + size;\n";
+        if(reads_bytes) out += "    unsigned char c;\n";
+    } else {
+        out += "    (void)data;\n";
+        out += "    (void)size;\n";
+    }
+    out += order.empty() ? "    return false;\n" : body;
+    out += "}\n\n";
+    out += "bool " + this->function_name + "(std::string_view input) {\n";
+    out += "    return " + this->function_name + "(input.data(), input.size());\n";
+    out += "}\n";
+    return out;
+}
+
+vector<DFACodeGenerator::Range> DFACodeGenerator::GetRanges(std::uint32_t state) const {
+    const std::uint32_t* row = this->dfa.GetTable() + static_cast<size_t>(state) * this->dfa.GetClassCount();
+    const unsigned char* classes = this->dfa.GetByteClasses();
+    vector<Range> ranges;
+    for(int c = 0; c < 256; ++c) {
+        std::uint32_t target = row[classes[c]];
+        if(!ranges.empty() && ranges.back().target == target) ranges.back().high = static_cast<unsigned char>(c);
+        else ranges.push_back({static_cast<unsigned char>(c), static_cast<unsigned char>(c), target});
+    }
+    return ranges;
+}
+
+void DFACodeGenerator::EmitState(string& out, std::uint32_t state, bool labeled) const {
+    vector<Range> ranges = GetRanges(state);
+    string accept = this->dfa.IsAccepting(state) ? "true" : "false";
+    if(labeled) out += GetLabel(state) + ":\n";
+
+    //A state that stays put on every byte decides the match on its own,
+    //and one that leaves for the same state on every byte needn't look at
+    //the byte.
+    if(ranges.size() == 1) {
+        if(ranges[0].target == state) {
+            out += "    return " + accept + ";\n";
+        } else {
+            out += "    if(p == end) return " + accept + ";\n";
+            out += "    ++p;\n";
+            out += "    " + GetJump(ranges[0].target) + "\n";
+        }
+        return;
+    }
+
+    EmitSkipLoop(out, state, ranges);
+    out += "    if(p == end) return " + accept + ";\n";
+    out += "    c = *p++;\n";
+    EmitDispatch(out, ranges, 0, ranges.size(), 1);
+    return;
+}
+
+void DFACodeGenerator::EmitSkipLoop(string& out, std::uint32_t state, const vector<Range>& ranges) const {
+    vector<pair<unsigned char, unsigned char>> stays, exits;
+    for(const Range& range : ranges) {
+        if(range.target == state) stays.push_back({range.low, range.high});
+        else if(exits.empty() || exits.back().second + 1 != range.low) exits.push_back({range.low, range.high});
+        else exits.back().second = range.high;
+    }
+    if(stays.empty()) return;
+
+    //Test whichever of the two sets has fewer ranges, a state like the one
+    //for ".*" stays on almost everything and leaves on '\n' alone.
+    bool test_exits = exits.size() < stays.size();
+    const vector<pair<unsigned char, unsigned char>>& tested = test_exits ? exits : stays;
+    if(tested.size() <= kMaxSkipRanges) {
+        out += "#ifdef DFA_CODEGEN_SSE2\n";
+        out += "    while(end - p >= 16) {\n";
+        out += "        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));\n";
+        out += "        const __m128i hits = " + GetVectorTest(tested) + ";\n";
+        if(test_exits) out += "        const unsigned exits = static_cast<unsigned>(_mm_movemask_epi8(hits));\n";
+        else out += "        const unsigned exits = ~static_cast<unsigned>(_mm_movemask_epi8(hits)) & 0xFFFF;\n";
+        out += "        if(exits != 0) {\n";
+        out += "            p += __builtin_ctz(exits);\n";
+        out += "            break;\n";
+        out += "        }\n";
+        out += "        p += 16;\n";
+        out += "    }\n";
+        out += "#endif\n";
+    }
+    string test = GetScalarTest("*p", tested);
+    if(tested.size() > 1 || test_exits) test = "(" + test + ")";
+    out += "    while(p != end && " + string(test_exits ? "!" : "") + test + ") ++p;\n";
+    return;
+}
+
+void DFACodeGenerator::EmitDispatch(string& out, const vector<Range>& ranges, size_t first, size_t last, size_t indent) const {
+    string pad(4 * indent, ' ');
+
+    //A few ranges are tested in order, each ruling out the bytes below the
+    //next one. More are split in half first, so a state with r ranges takes
+    //about log2(r) comparisons.
+    if(last - first <= 4) {
+        for(size_t i = first; i + 1 < last; ++i)
+            out += pad + "if(c <= " + GetByteLiteral(ranges[i].high) + ") " + GetJump(ranges[i].target) + "\n";
+        out += pad + GetJump(ranges[last - 1].target) + "\n";
+        return;
+    }
+    size_t middle = first + (last - first) / 2;
+    out += pad + "if(c < " + GetByteLiteral(ranges[middle].low) + ") {\n";
+    EmitDispatch(out, ranges, first, middle, indent + 1);
+    out += pad + "} else {\n";
+    EmitDispatch(out, ranges, middle, last, indent + 1);
+    out += pad + "}\n";
+    return;
+}
+
+string DFACodeGenerator::GetJump(std::uint32_t target) const {
+    if(target == this->dfa.GetDeadState()) return "return false;";
+    return "goto " + GetLabel(target) + ";";
+}
+
+//END OF DFACODEGENERATOR CLASS IMPLEMENTATION
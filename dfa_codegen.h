@@ -0,0 +1,74 @@
+#pragma once
+
+/*
+ * Filename: dfa_codegen.h
+ * Programmer: Abdurrahman Alyajouri
+ * Date: 10/17/2026
+ * Purpose: The purpose of this file is to define the DFACodeGenerator class,
+ *          which turns a DFA into the C++ source of a standalone matcher in
+ *          the style of re2c. Every state becomes a label, and its
+ *          transitions become a binary search over byte ranges ending in a
+ *          goto, so matching takes no table loads at all. States that loop
+ *          on themselves, like the one for "s*" in "Worlds*", first skip
+ *          over the bytes they stay on, 16 at a time with SSE2. The
+ *          generated code only needs the standard library.
+ */
+
+#include "dfa.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using std::size_t;
+using std::string;
+using std::vector;
+
+class DFACodeGenerator {
+    public:
+        //Ctor. "function_name" names the generated matcher, and "a_dfa"
+        //must outlive the generator. Throws std::invalid_argument if
+        //"function_name" is not a valid C++ identifier.
+        DFACodeGenerator(const DFA& a_dfa, const string& function_name);
+
+        //Returns a header declaring the matcher, which takes either a
+        //pointer and a size or a string_view and checks if the whole input
+        //is matched, like DFA::Match.
+        string GenerateHeader(void) const;
+
+        //Returns the source file defining the matcher.
+        string GenerateSource(void) const;
+
+    private:
+        //Most byte ranges a skip loop tests per 16 bytes. States that stay
+        //on, or leave on, more ranges than this go byte by byte.
+        static constexpr size_t kMaxSkipRanges = 4;
+
+        //A run of bytes that all lead to "target" from some state.
+        struct Range {
+            unsigned char low;
+            unsigned char high;
+            std::uint32_t target;
+        };
+
+        //Splits the transitions of "state" into maximal ranges of bytes
+        //with the same target, in byte order.
+        vector<Range> GetRanges(std::uint32_t state) const;
+
+        //Appends the code of "state", which starts at its label.
+        void EmitState(string& out, std::uint32_t state, bool labeled) const;
+
+        //Appends a loop advancing "p" past the bytes that keep "state" in
+        //itself, given the ranges of its transitions.
+        void EmitSkipLoop(string& out, std::uint32_t state, const vector<Range>& ranges) const;
+
+        //Appends the comparisons picking the range "c" falls in, out of
+        //ranges "first" to "last" - 1, with each line indented by "indent".
+        void EmitDispatch(string& out, const vector<Range>& ranges, size_t first, size_t last, size_t indent) const;
+
+        //Returns the statement taking the transition to "target".
+        string GetJump(std::uint32_t target) const;
+
+        const DFA& dfa;
+        string function_name;
+};
@@ -0,0 +1,176 @@
+/*
+ * Filename: dfa_layout.cpp
+ * Programmer: Abdurrahman Alyajouri
+ * Date: 10/17/2026
+ * Purpose: The purpose of this file is to implement the DFAProfile and
+ *          DFALayout classes declared in "dfa_layout.h".
+ */
+
+#include "dfa_layout.h"
+#include <algorithm>
+#include <queue>
+#include <stdexcept>
+#include <vector>
+
+using std::queue;
+using std::vector;
+
+//BEGINNING OF DFAPROFILE CLASS IMPLEMENTATION
+
+DFAProfile::DFAProfile(const DFA& a_dfa) : dfa(a_dfa), visits(a_dfa.GetStateCount(), 0) {}
+
+void DFAProfile::Record(string_view input) {
+    if(this->dfa.GetStateCount() == 0) return;
+    const std::uint32_t* table = this->dfa.GetTable();
+    const unsigned char* byte_classes = this->dfa.GetByteClasses();
+    std::uint32_t class_count = this->dfa.GetClassCount();
+    std::uint32_t state = this->dfa.GetStartState();
+    ++this->visits[state];
+    for(unsigned char c : input) {
+        if(state == this->dfa.GetDeadState()) break;
+        state = table[static_cast<size_t>(state) * class_count + byte_classes[c]];
+        ++this->visits[state];
+    }
+    return;
+}
+
+std::uint64_t DFAProfile::GetVisits(std::uint32_t state) const {
+    return this->visits[state];
+}
+
+const DFA& DFAProfile::GetDFA(void) const {
+    return this->dfa;
+}
+
+//END OF DFAPROFILE CLASS IMPLEMENTATION
+
+//BEGINNING OF DFALAYOUT CLASS IMPLEMENTATION
+
+DFALayout::DFALayout(const DFA& a_dfa) {
+    Build(a_dfa, nullptr);
+}
+
+DFALayout::DFALayout(const DFA& a_dfa, const DFAProfile& profile) {
+    if(&profile.GetDFA() != &a_dfa) throw std::invalid_argument("The profile is of another DFA.");
+    vector<std::uint64_t> visits(a_dfa.GetStateCount());
+    for(std::uint32_t s = 0; s < a_dfa.GetStateCount(); ++s) visits[s] = profile.GetVisits(s);
+    Build(a_dfa, &visits);
+}
+
+bool DFALayout::Match(string_view input) const {
+    if(this->id_width == 1) return Run(this->table8, input);
+    if(this->id_width == 2) return Run(this->table16, input);
+    return Run(this->table32, input);
+}
+
+size_t DFALayout::GetIdWidth(void) const {
+    return this->id_width;
+}
+
+std::uint32_t DFALayout::GetStateCount(void) const {
+    return this->state_count;
+}
+
+std::uint32_t DFALayout::GetStateId(std::uint32_t state) const {
+    return this->ids[state];
+}
+
+size_t DFALayout::GetMemoryUsage(void) const {
+    return static_cast<size_t>(this->state_count) * this->class_count * this->id_width;
+}
+
+void DFALayout::Build(const DFA& a_dfa, const vector<std::uint64_t>* visits) {
+    std::uint32_t dfa_states = a_dfa.GetStateCount();
+    std::uint32_t dead = a_dfa.GetDeadState();
+    const std::uint32_t* table = a_dfa.GetTable();
+    this->class_count = a_dfa.GetClassCount();
+    std::copy(a_dfa.GetByteClasses(), a_dfa.GetByteClasses() + 256, this->byte_classes);
+
+    //Rank the states by when a breadth first walk from the start state
+    //reaches them. States it never reaches rank last.
+    vector<std::uint32_t> bfs_rank(dfa_states, dfa_states);
+    if(dfa_states > 0) {
+        queue<std::uint32_t> pending;
+        std::uint32_t next_rank = 0;
+        pending.push(a_dfa.GetStartState());
+        bfs_rank[a_dfa.GetStartState()] = next_rank++;
+        while(!pending.empty()) {
+            std::uint32_t s = pending.front();
+            pending.pop();
+            for(std::uint32_t k = 0; k < this->class_count; ++k) {
+                std::uint32_t target = table[static_cast<size_t>(s) * this->class_count + k];
+                if(bfs_rank[target] != dfa_states) continue;
+                bfs_rank[target] = next_rank++;
+                pending.push(target);
+            }
+        }
+    }
+
+    //Row 0 is the dead state, then come the other states that don't
+    //accept, then the ones that do, so the two checks the matching loop
+    //makes are single comparisons. A DFA without a dead state gets an
+    //unreachable one. Within each group the states are sorted hottest
+    //first, and the first group is then reversed, so the hottest states
+    //of both groups end up next to each other in the middle.
+    auto hotter = [&](std::uint32_t a, std::uint32_t b) {
+        if(visits && (*visits)[a] != (*visits)[b]) return (*visits)[a] > (*visits)[b];
+        return bfs_rank[a] < bfs_rank[b];
+    };
+    vector<std::uint32_t> rejecting, accepting;
+    for(std::uint32_t s = 0; s < dfa_states; ++s) {
+        if(s == dead) continue;
+        if(a_dfa.IsAccepting(s)) accepting.push_back(s);
+        else rejecting.push_back(s);
+    }
+    std::sort(rejecting.begin(), rejecting.end(), hotter);
+    std::sort(accepting.begin(), accepting.end(), hotter);
+    std::reverse(rejecting.begin(), rejecting.end());
+
+    this->state_count = static_cast<std::uint32_t>(1 + rejecting.size() + accepting.size());
+    std::uint64_t largest_id = static_cast<std::uint64_t>(this->state_count - 1) * this->class_count;
+    if(static_cast<std::uint64_t>(this->state_count) * this->class_count > 0xFFFFFFFF)
+        throw std::length_error("The DFA is too large to lay out with 32-bit ids.");
+    this->id_width = largest_id <= 0xFF ? 1 : largest_id <= 0xFFFF ? 2 : 4;
+
+    this->ids.assign(dfa_states, 0);
+    vector<std::uint32_t> order(1, dead);
+    order.insert(order.end(), rejecting.begin(), rejecting.end());
+    order.insert(order.end(), accepting.begin(), accepting.end());
+    for(std::uint32_t row = 1; row < this->state_count; ++row) this->ids[order[row]] = row * this->class_count;
+    this->first_accepting_id = static_cast<std::uint32_t>(1 + rejecting.size()) * this->class_count;
+    this->start_id = dfa_states > 0 ? this->ids[a_dfa.GetStartState()] : 0;
+
+    //Fill the rows in, leaving the dead state's all zeros so it loops on
+    //itself.
+    vector<std::uint32_t> entries(static_cast<size_t>(this->state_count) * this->class_count, 0);
+    for(std::uint32_t row = 1; row < this->state_count; ++row) {
+        const std::uint32_t* old_row = table + static_cast<size_t>(order[row]) * this->class_count;
+        for(std::uint32_t k = 0; k < this->class_count; ++k)
+            entries[static_cast<size_t>(row) * this->class_count + k] = this->ids[old_row[k]];
+    }
+    if(this->id_width == 1) this->table8.assign(entries.begin(), entries.end());
+    else if(this->id_width == 2) this->table16.assign(entries.begin(), entries.end());
+    else this->table32.swap(entries);
+    return;
+}
+
+template <typename Id>
+bool DFALayout::Run(const vector<Id>& table, string_view input) const {
+    //Every transition of the dead state leads back to it, so looking for it
+    //once every 4 bytes is enough to stop early.
+    const Id* rows = table.data();
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(input.data());
+    size_t size = input.size(), i = 0;
+    std::uint32_t id = this->start_id;
+    for(; i + 4 <= size; i += 4) {
+        id = rows[id + this->byte_classes[bytes[i]]];
+        id = rows[id + this->byte_classes[bytes[i + 1]]];
+        id = rows[id + this->byte_classes[bytes[i + 2]]];
+        id = rows[id + this->byte_classes[bytes[i + 3]]];
+        if(id == 0) return false;
+    }
+    for(; i < size; ++i) id = rows[id + this->byte_classes[bytes[i]]];
+    return id >= this->first_accepting_id;
+}
+
+//END OF DFALAYOUT CLASS IMPLEMENTATION
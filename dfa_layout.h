@@ -0,0 +1,98 @@
+#pragma once
+
+/*
+ * Filename: dfa_layout.h
+ * Programmer: Abdurrahman Alyajouri
+ * Date: 10/17/2026
+ * Purpose: The purpose of this file is to define the DFAProfile and
+ *          DFALayout classes. DFALayout copies the table of a DFA into a
+ *          layout that is cheaper to run: states are renumbered so the ones
+ *          matching spends its time in share cache lines, each transition
+ *          holds the offset of its target's row instead of its number, so
+ *          the next lookup needs no multiply, and the entries are 8, 16 or
+ *          32 bits wide, whichever is the smallest that fits. DFAProfile
+ *          counts how often sample input visits each state, for DFALayout
+ *          to order the states by.
+ */
+
+#include "dfa.h"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+using std::size_t;
+using std::string_view;
+using std::vector;
+
+class DFAProfile {
+    public:
+        //Ctor. "a_dfa" must outlive the profile.
+        explicit DFAProfile(const DFA& a_dfa);
+
+        //Runs "input" through the DFA like DFA::Match, counting every
+        //state it visits.
+        void Record(string_view input);
+
+        //Returns the number of times "state" was visited.
+        std::uint64_t GetVisits(std::uint32_t state) const;
+
+        //Returns the DFA being profiled.
+        const DFA& GetDFA(void) const;
+
+    private:
+        const DFA& dfa;
+        vector<std::uint64_t> visits; //One count per state.
+};
+
+class DFALayout {
+    public:
+        //Ctors. The first one orders the states by when a breadth first
+        //walk from the start state reaches them. The second one orders them
+        //by how often "profile" visited them, falling back on the breadth
+        //first order for ties, and must be given a profile of "a_dfa".
+        explicit DFALayout(const DFA& a_dfa);
+        DFALayout(const DFA& a_dfa, const DFAProfile& profile);
+
+        //Checks if the whole input is matched, like DFA::Match.
+        bool Match(string_view input) const;
+
+        //Returns the size of a table entry in bytes, 1, 2 or 4.
+        size_t GetIdWidth(void) const;
+
+        //Returns the number of rows in the table, which is one more than
+        //the DFA's states if the DFA had no dead state.
+        std::uint32_t GetStateCount(void) const;
+
+        //Returns the id "state" of the DFA was given, the offset of its
+        //row in the table.
+        std::uint32_t GetStateId(std::uint32_t state) const;
+
+        //Returns the number of bytes the table takes up.
+        size_t GetMemoryUsage(void) const;
+
+    private:
+        //Renumbers the states and fills the table in, ordering the states
+        //by "visits" if it isn't null.
+        void Build(const DFA& a_dfa, const vector<std::uint64_t>* visits);
+
+        //Runs "input" through "table".
+        template <typename Id>
+        bool Run(const vector<Id>& table, string_view input) const;
+
+        std::uint32_t state_count;
+        std::uint32_t class_count;
+
+        //Ids are row offsets, "state_count * class_count" at most. The
+        //dead state is always 0 and the accepting states come last, so
+        //either check takes one comparison.
+        std::uint32_t start_id;
+        std::uint32_t first_accepting_id;
+        vector<std::uint32_t> ids; //Id of each of the DFA's states.
+
+        unsigned char byte_classes[256];
+        size_t id_width;
+        vector<std::uint8_t> table8; //Only the table of "id_width" is filled.
+        vector<std::uint16_t> table16;
+        vector<std::uint32_t> table32;
+};
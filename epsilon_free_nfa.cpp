@@ -0,0 +1,109 @@
+/*
+ * Filename: epsilon_free_nfa.cpp
+ * Programmer: Abdurrahman Alyajouri
+ * Date: 10/17/2026
+ * Purpose: The purpose of this file is to implement the EpsilonFreeNFA class
+ *          declared in "epsilon_free_nfa.h".
+ */
+
+#include "epsilon_free_nfa.h"
+#include <vector>
+
+using std::vector;
+
+//BEGINNING OF EPSILONFREENFA CLASS IMPLEMENTATION
+
+EpsilonFreeNFA::EpsilonFreeNFA() : start_first(0), start_last(0) {}
+
+EpsilonFreeNFA::EpsilonFreeNFA(const TNFA& nfa) : EpsilonFreeNFA() {
+    if(nfa.IsEmpty()) return;
+
+    //Number the states worth keeping: the ones that consume a byte and the
+    //accept state. Every other state is only ever passed through.
+    const std::uint32_t kDropped = 0xFFFFFFFF;
+    vector<std::uint32_t> numbers(nfa.GetStateCount(), kDropped);
+    for(StateId id = 0; id < nfa.GetStateCount(); ++id) {
+        const ::State& state = nfa.GetState(id);
+        if(!state.HasSymbolTransition() && !state.acceptance) continue;
+        numbers[id] = static_cast<std::uint32_t>(this->states.size());
+        this->states.push_back({state.low, state.high, state.HasSymbolTransition(), state.acceptance, 0, 0});
+    }
+
+    //Appends the kept states of the epsilon closure of "state" to the
+    //successor list. Returns false if the list grew past kMaxEdges.
+    vector<size_t> marks(nfa.GetStateCount(), 0);
+    vector<StateId> pending;
+    size_t step = 0;
+    auto closure = [&](StateId state) {
+        ++step;
+        marks[state] = step;
+        pending.assign(1, state);
+        while(!pending.empty()) {
+            StateId id = pending.back();
+            pending.pop_back();
+            if(numbers[id] != kDropped) this->successors.push_back(numbers[id]);
+
+            const ::State& current = nfa.GetState(id);
+            for(int i = 0; i < current.epsilon_count; ++i) {
+                StateId next_state = current.epsilon_transitions[i];
+                if(marks[next_state] != step) {
+                    marks[next_state] = step;
+                    pending.push_back(next_state);
+                }
+            }
+        }
+        return this->successors.size() <= kMaxEdges;
+    };
+
+    for(StateId id = 0; id < nfa.GetStateCount(); ++id) {
+        if(numbers[id] == kDropped || !this->states[numbers[id]].consumes) continue;
+        State& state = this->states[numbers[id]];
+        state.first_successor = static_cast<std::uint32_t>(this->successors.size());
+        if(!closure(nfa.GetState(id).symbol_transition)) {
+            *this = EpsilonFreeNFA();
+            return;
+        }
+        state.last_successor = static_cast<std::uint32_t>(this->successors.size());
+    }
+
+    this->start_first = static_cast<std::uint32_t>(this->successors.size());
+    if(!closure(nfa.GetStartState())) {
+        *this = EpsilonFreeNFA();
+        return;
+    }
+    this->start_last = static_cast<std::uint32_t>(this->successors.size());
+    this->successors.shrink_to_fit();
+}
+
+bool EpsilonFreeNFA::IsBuilt(void) const {
+    return !this->states.empty();
+}
+
+size_t EpsilonFreeNFA::GetStateCount(void) const {
+    return this->states.size();
+}
+
+size_t EpsilonFreeNFA::GetEdgeCount(void) const {
+    return this->successors.size();
+}
+
+size_t EpsilonFreeNFA::GetMemoryUsage(void) const {
+    return this->states.capacity() * sizeof(State) + this->successors.capacity() * sizeof(std::uint32_t);
+}
+
+const EpsilonFreeNFA::State& EpsilonFreeNFA::GetState(std::uint32_t id) const {
+    return this->states[id];
+}
+
+EpsilonFreeNFA::Successors EpsilonFreeNFA::GetStartStates(void) const {
+    const std::uint32_t* list = this->successors.data();
+    return Successors{list + this->start_first, list + this->start_last};
+}
+
+EpsilonFreeNFA::Successors EpsilonFreeNFA::GetSuccessors(std::uint32_t id) const {
+    const std::uint32_t* list = this->successors.data();
+    const State& state = this->states[id];
+    return Successors{list + state.first_successor, list + state.last_successor};
+}
+
+//END OF EPSILONFREENFA CLASS IMPLEMENTATION
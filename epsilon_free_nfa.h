@@ -0,0 +1,87 @@
+#pragma once
+
+/*
+ * Filename: epsilon_free_nfa.h
+ * Programmer: Abdurrahman Alyajouri
+ * Date: 10/17/2026
+ * Purpose: The purpose of this file is to define the EpsilonFreeNFA class,
+ *          a TNFA with its epsilon transitions compiled away. Only the states
+ *          that consume a byte or accept are kept, and each one lists the
+ *          states in the epsilon closure of where its symbol transition
+ *          leads. Simulating it takes one flat loop per input byte instead
+ *          of an epsilon walk per reached state, and the set of active
+ *          states never holds states that only have epsilon transitions.
+ */
+
+#include "tnfa.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using std::size_t;
+using std::vector;
+
+class EpsilonFreeNFA {
+    public:
+        //Largest number of successors all states may list together. Each
+        //closure is stored separately, so patterns whose closures overlap
+        //a lot can need quadratic room. Those are left unbuilt.
+        static constexpr size_t kMaxEdges = 1 << 20;
+
+        //A state kept from the TNFA. Successors of state s are at
+        //"[first_successor, last_successor)" of the successor list.
+        struct State {
+            unsigned char low; //Range of bytes the state consumes.
+            unsigned char high;
+            bool consumes; //False for the accept state, which consumes nothing.
+            bool acceptance;
+            std::uint32_t first_successor;
+            std::uint32_t last_successor;
+
+            //Returns true if the state consumes byte "c".
+            bool Matches(char c) const {
+                unsigned char byte = static_cast<unsigned char>(c);
+                return this->consumes && this->low <= byte && byte <= this->high;
+            }
+        };
+
+        //A run of state indices in the successor list.
+        struct Successors {
+            const std::uint32_t* first;
+            const std::uint32_t* last;
+            const std::uint32_t* begin(void) const { return this->first; }
+            const std::uint32_t* end(void) const { return this->last; }
+        };
+
+        //Ctors. The first one creates an empty automaton that can't be used.
+        //The second one removes the epsilon transitions of "nfa", unless the
+        //result would have more than kMaxEdges successors.
+        EpsilonFreeNFA();
+        explicit EpsilonFreeNFA(const TNFA& nfa);
+
+        //Returns true if the automaton was built and may be used.
+        bool IsBuilt(void) const;
+
+        //Returns the number of states and successors, 0 if not built.
+        size_t GetStateCount(void) const;
+        size_t GetEdgeCount(void) const;
+
+        //Returns an estimate of the memory the automaton uses, in bytes.
+        size_t GetMemoryUsage(void) const;
+
+        //Access to the states. "GetState" expects a valid index.
+        const State& GetState(std::uint32_t id) const;
+
+        //Returns the states active before any input is read, i.e. the
+        //epsilon closure of the TNFA's start state.
+        Successors GetStartStates(void) const;
+
+        //Returns the states active after state "id" consumed a byte.
+        Successors GetSuccessors(std::uint32_t id) const;
+
+    private:
+        vector<State> states;
+        vector<std::uint32_t> successors; //Every state's successors, then the start states.
+        std::uint32_t start_first; //Start states in "successors".
+        std::uint32_t start_last;
+};
@@ -0,0 +1,248 @@
+/*
+ * Filename: lazy_dfa.cpp
+ * Programmer: Abdurrahman Alyajouri
+ * Date: 10/17/2026
+ * Purpose: The purpose of this file is to implement the LazyDFA class
+ *          declared in "lazy_dfa.h".
+ */
+
+#include "lazy_dfa.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+//BEGINNING OF LAZYDFA CLASS IMPLEMENTATION
+
+LazyDFA::LazyDFA() : LazyDFA(kDefaultCacheBudget) {}
+
+LazyDFA::LazyDFA(size_t a_cache_budget, bool is_unanchored)
+    : cache_budget(a_cache_budget), memory_used(0), stride(0), start(kUnknown), bytes_since_flush(0),
+      unanchored(is_unanchored), call_count(0), counters{0, 0, 0}, generation(0) {}
+
+LazyDFA::LazyDFA(const LazyDFA& a_dfa) : LazyDFA(a_dfa.cache_budget, a_dfa.unanchored) {}
+
+LazyDFA& LazyDFA::operator=(const LazyDFA& a_dfa) {
+    if(this == &a_dfa) return *this;
+    this->cache_budget = a_dfa.cache_budget;
+    this->unanchored = a_dfa.unanchored;
+    Flush();
+    return *this;
+}
+
+size_t LazyDFA::GetCacheBudget(void) const {
+    return this->cache_budget;
+}
+
+void LazyDFA::SetCacheBudget(size_t a_cache_budget) {
+    this->cache_budget = a_cache_budget;
+    Flush();
+    return;
+}
+
+bool LazyDFA::IsUnanchored(void) const {
+    return this->unanchored;
+}
+
+const LazyDFA::Counters& LazyDFA::GetCounters(void) const {
+    return this->counters;
+}
+
+void LazyDFA::ResetCounters(void) {
+    this->counters = Counters{0, 0, 0};
+    return;
+}
+
+void LazyDFA::Flush(void) {
+    if constexpr(kRegexStatsEnabled) {
+        if(!this->states.empty()) ++this->counters.flushes;
+    }
+    this->states.clear();
+    this->transitions.clear();
+    this->state_map.clear();
+    this->memory_used = 0;
+    this->start = kUnknown;
+    this->bytes_since_flush = 0;
+    return;
+}
+
+LazyDFA::Result LazyDFA::Match(const TNFA& nfa, const ByteClasses& classes, string_view input,
+                               vector<StateId>* accepting) {
+    if(accepting) accepting->clear();
+    if(nfa.IsEmpty()) return Result::kNoMatch;
+    ++this->call_count;
+
+    //The rows of the table have one entry per byte class.
+    if(this->stride != classes.GetCount()) {
+        Flush();
+        this->stride = classes.GetCount();
+    }
+
+    //Build the start state if the cache does not have it.
+    if(this->start == kUnknown) {
+        this->stack.assign(1, nfa.GetStartState());
+        Closure(nfa, this->stack, this->closure);
+        this->start = AddState(nfa, this->closure);
+        if(this->start == kUnknown) return Result::kGaveUp;
+    }
+
+    int current = this->start;
+    bool matched = false;
+    for(unsigned char c : input) {
+        //An unanchored match may end anywhere, not just at the end.
+        if(this->unanchored && this->states[current].acceptance) {
+            if(!accepting) return Result::kMatch;
+            matched = true;
+            Report(nfa, current, *accepting);
+        }
+
+        int next = this->transitions[current * this->stride + classes.Get(c)];
+        if constexpr(kRegexStatsEnabled) ++this->counters.lookups;
+
+        if(next == kUnknown) {
+            if constexpr(kRegexStatsEnabled) ++this->counters.misses;
+            next = ComputeNext(nfa, classes, current, c);
+
+            //Out of room. Flush the cache and try again, unless the cache
+            //was already flushed recently, in which case it is thrashing.
+            if(next == kUnknown) {
+                if(this->bytes_since_flush < kMinBytesPerState * this->states.size())
+                    return Result::kGaveUp;
+
+                vector<StateId> saved = this->states[current].nfa_states;
+                Flush();
+                current = AddState(nfa, saved);
+                if(current == kUnknown) return Result::kGaveUp;
+                next = ComputeNext(nfa, classes, current, c);
+                if(next == kUnknown) return Result::kGaveUp;
+            }
+        }
+
+        current = next;
+        ++this->bytes_since_flush;
+
+        //The empty set can never reach an accepting state again. An
+        //unanchored LazyDFA never gets there since the start state is
+        //part of every state.
+        if(this->states[current].nfa_states.empty()) return Result::kNoMatch;
+    }
+
+    if(this->states[current].acceptance) {
+        matched = true;
+        if(accepting) Report(nfa, current, *accepting);
+    }
+    //Different deterministic states may share accepting NFA states.
+    if(accepting) {
+        std::sort(accepting->begin(), accepting->end());
+        accepting->erase(std::unique(accepting->begin(), accepting->end()), accepting->end());
+    }
+
+    return matched ? Result::kMatch : Result::kNoMatch;
+}
+
+size_t LazyDFA::StateSetHash::operator()(const vector<StateId>& a_set) const {
+    size_t hash = a_set.size();
+    for(StateId state : a_set)
+        hash ^= state + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+void LazyDFA::Closure(const TNFA& nfa, vector<StateId>& stack, vector<StateId>& result) {
+    //Start a new generation of marks, resetting them when the counter wraps.
+    if(this->marks.size() != nfa.GetStateCount()) this->marks.assign(nfa.GetStateCount(), 0);
+    if(++this->generation == 0) {
+        std::fill(this->marks.begin(), this->marks.end(), 0);
+        this->generation = 1;
+    }
+    result.clear();
+
+    //Mark the seeds, dropping duplicates.
+    size_t seed_count = 0;
+    for(StateId id : stack) {
+        if(this->marks[id] == this->generation) continue;
+        this->marks[id] = this->generation;
+        stack[seed_count++] = id;
+    }
+    stack.resize(seed_count);
+
+    //Walk the epsilon transitions with an explicit stack.
+    while(!stack.empty()) {
+        StateId id = stack.back();
+        stack.pop_back();
+        const State& current = nfa.GetState(id);
+
+        //States that only have epsilon transitions do not affect which
+        //states are reachable next, so they are left out of the set.
+        if(current.HasSymbolTransition() || current.acceptance) result.push_back(id);
+
+        for(int i = 0; i < current.epsilon_count; ++i) {
+            StateId next_state = current.epsilon_transitions[i];
+            if(this->marks[next_state] != this->generation) {
+                this->marks[next_state] = this->generation;
+                stack.push_back(next_state);
+            }
+        }
+    }
+
+    std::sort(result.begin(), result.end());
+    return;
+}
+
+int LazyDFA::AddState(const TNFA& nfa, const vector<StateId>& nfa_states) {
+    auto found = this->state_map.find(nfa_states);
+    if(found != this->state_map.end()) return found->second;
+
+    size_t cost = StateCost(nfa_states);
+    if(this->memory_used + cost > this->cache_budget) return kUnknown;
+    this->memory_used += cost;
+
+    DState new_state;
+    new_state.nfa_states = nfa_states;
+    new_state.acceptance = false;
+    new_state.reported = 0;
+    for(StateId id : nfa_states)
+        if(nfa.GetState(id).acceptance) new_state.acceptance = true;
+
+    int index = static_cast<int>(this->states.size());
+    this->states.push_back(std::move(new_state));
+    this->transitions.resize(this->transitions.size() + this->stride, kUnknown);
+    this->state_map.insert({nfa_states, index});
+    return index;
+}
+
+int LazyDFA::ComputeNext(const TNFA& nfa, const ByteClasses& classes, int from, unsigned char c) {
+    this->stack.clear();
+    for(StateId id : this->states[from].nfa_states) {
+        const State& state = nfa.GetState(id);
+        if(state.Matches(static_cast<char>(c)))
+            this->stack.push_back(state.symbol_transition);
+    }
+
+    //An unanchored search starts a new attempt at every byte. The closure
+    //drops duplicate seeds.
+    if(this->unanchored) this->stack.push_back(nfa.GetStartState());
+    Closure(nfa, this->stack, this->closure);
+    int next = AddState(nfa, this->closure);
+    if(next != kUnknown) this->transitions[from * this->stride + classes.Get(c)] = next;
+    return next;
+}
+
+void LazyDFA::Report(const TNFA& nfa, int id, vector<StateId>& accepting) {
+    DState& state = this->states[id];
+    if(state.reported == this->call_count) return;
+    state.reported = this->call_count;
+    for(StateId nfa_state : state.nfa_states)
+        if(nfa.GetState(nfa_state).acceptance) accepting.push_back(nfa_state);
+    return;
+}
+
+size_t LazyDFA::StateCost(const vector<StateId>& nfa_states) const {
+    //The state itself, its row of the table, its set stored twice (state
+    //and map key), and a rough allowance for the hash map node.
+    return sizeof(DState) + this->stride * sizeof(int) + 2 * nfa_states.size() * sizeof(StateId) +
+           4 * sizeof(void*);
+}
+
+//END OF LAZYDFA CLASS IMPLEMENTATION
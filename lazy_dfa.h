@@ -0,0 +1,145 @@
+#pragma once
+
+/*
+ * Filename: lazy_dfa.h
+ * Programmer: Abdurrahman Alyajouri
+ * Date: 10/17/2026
+ * Purpose: The purpose of this file is to define the LazyDFA class. A LazyDFA
+ *          performs the subset construction of a TNFA on demand, only
+ *          building the deterministic states the input actually visits, and
+ *          caches them under a configurable memory budget. Once the cache is
+ *          warm, matching costs one table lookup per input byte. The table
+ *          is indexed by byte class rather than by byte.
+ */
+
+#include "regex_stats.h"
+#include "tnfa.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using std::size_t;
+using std::string;
+using std::string_view;
+using std::unordered_map;
+using std::vector;
+
+class LazyDFA {
+    public:
+        //Outcome of a match attempt. "kGaveUp" means the cache was thrashing
+        //and the caller should fall back to simulating the NFA directly.
+        enum class Result { kMatch, kNoMatch, kGaveUp };
+
+        //Default cache budget in bytes.
+        static constexpr size_t kDefaultCacheBudget = 2 * 1024 * 1024;
+
+        //Ctors. An unanchored LazyDFA looks for matches of "nfa" anywhere
+        //in the input instead of the whole input. Copying a LazyDFA only
+        //copies its configuration, the cached states belong to the
+        //automaton they were built from.
+        LazyDFA();
+        explicit LazyDFA(size_t a_cache_budget, bool is_unanchored = false);
+        LazyDFA(const LazyDFA& a_dfa);
+        LazyDFA& operator=(const LazyDFA& a_dfa);
+
+        //Get and set the memory budget of the state cache. Changing the
+        //budget flushes the cache.
+        size_t GetCacheBudget(void) const;
+        void SetCacheBudget(size_t a_cache_budget);
+
+        //Returns true if the LazyDFA matches anywhere in the input.
+        bool IsUnanchored(void) const;
+
+        //Throws away every cached state. Must be called whenever the TNFA
+        //the cache was built from changes.
+        void Flush(void);
+
+        //Runs "input" through the deterministic equivalent of "nfa", building
+        //states as they are needed. "classes" must be the byte classes of
+        //"nfa". Unless the LazyDFA is unanchored, only
+        //looks for exact matches from the beginning of a string to the end.
+        //If "accepting" is given, it receives every accepting NFA state that
+        //matched, sorted. For an unanchored LazyDFA that means the whole
+        //input is scanned instead of stopping at the first match.
+        Result Match(const TNFA& nfa, const ByteClasses& classes, string_view input,
+                     vector<StateId>* accepting = nullptr);
+
+        //What the cache did so far. Only counted when built with
+        //REGEX_ENABLE_STATS, zero otherwise. Survives flushes.
+        struct Counters {
+            std::uint64_t lookups; //Transitions taken, found or built.
+            std::uint64_t misses; //Transitions that had to be built.
+            std::uint64_t flushes;
+        };
+        const Counters& GetCounters(void) const;
+        void ResetCounters(void);
+
+    private:
+        //Marks a transition that has not been computed yet.
+        static constexpr int kUnknown = -1;
+
+        //If the cache fills up before this many bytes were scanned per
+        //state built since the last flush, it is considered to be thrashing.
+        static constexpr size_t kMinBytesPerState = 10;
+
+        //A deterministic state, which stands for a set of NFA states.
+        struct DState {
+            vector<StateId> nfa_states; //Sorted, only states that matter.
+            bool acceptance;
+            size_t reported; //Last call whose "accepting" has this state's.
+        };
+
+        //Hashes the NFA state sets so they can be looked up in "state_map".
+        struct StateSetHash {
+            size_t operator()(const vector<StateId>& a_set) const;
+        };
+
+        //Computes the epsilon closure of the states in "stack" of "nfa" and writes
+        //the states that matter for the subset construction (the ones with
+        //symbol transitions and the accepting one), sorted, to "result".
+        void Closure(const TNFA& nfa, vector<StateId>& stack, vector<StateId>& result);
+
+        //Returns the index of the deterministic state for "nfa_states",
+        //building it if it is not cached yet. Returns kUnknown if the cache
+        //is full.
+        int AddState(const TNFA& nfa, const vector<StateId>& nfa_states);
+
+        //Computes the transition of deterministic state "from" on byte "c",
+        //which stands for its whole class.
+        //Returns kUnknown if the cache ran out of room.
+        int ComputeNext(const TNFA& nfa, const ByteClasses& classes, int from, unsigned char c);
+
+        //Adds the accepting NFA states of deterministic state "id" to
+        //"accepting", unless this call already did.
+        void Report(const TNFA& nfa, int id, vector<StateId>& accepting);
+
+        //Returns an estimate of the memory used by a cached state.
+        size_t StateCost(const vector<StateId>& nfa_states) const;
+
+        size_t cache_budget; //Maximum memory the cache may use, in bytes.
+        size_t memory_used; //Memory currently used by the cache, in bytes.
+
+        vector<DState> states; //Cached deterministic states.
+
+        //Transition table. The transition of state s on a byte of class k
+        //is at "transitions[s * stride + k]".
+        vector<int> transitions;
+        size_t stride; //Number of byte classes.
+        unordered_map<vector<StateId>, int, StateSetHash> state_map;
+
+        int start; //Index of the start state, or kUnknown.
+        size_t bytes_since_flush; //Input scanned since the last flush.
+        bool unanchored; //Whether a match may start anywhere.
+        size_t call_count; //Number of calls to Match so far.
+        Counters counters;
+
+        //Scratch buffers reused between closure computations. A state is
+        //visited in the current closure if its mark equals "generation".
+        vector<StateId> stack;
+        vector<StateId> closure;
+        vector<std::uint32_t> marks;
+        std::uint32_t generation;
+};
@@ -0,0 +1,72 @@
+/*
+ * Filename: match_context.cpp
+ * Programmer: Abdurrahman Alyajouri
+ * Date: 10/17/2026
+ * Purpose: The purpose of this file is to implement the MatchContext class
+ *          declared in "match_context.h".
+ */
+
+#include "match_context.h"
+#include <iterator>
+
+//BEGINNING OF MATCHCONTEXT CLASS IMPLEMENTATION
+
+MatchContext::MatchContext() : MatchContext(LazyDFA::kDefaultCacheBudget) {}
+
+MatchContext::MatchContext(size_t a_cache_budget) : cache_budget(a_cache_budget), last_step(0) {}
+
+MatchContext::MatchContext(const MatchContext& a_context) : MatchContext(a_context.cache_budget) {}
+
+MatchContext& MatchContext::operator=(const MatchContext& a_context) {
+    //The buffers and marks are scratch space of this context and stay, only
+    //the cached states go.
+    if(this == &a_context) return *this;
+    this->cache_budget = a_context.cache_budget;
+    this->dfa_caches.clear();
+    return *this;
+}
+
+size_t MatchContext::GetDFACacheBudget(void) const {
+    return this->cache_budget;
+}
+
+void MatchContext::SetDFACacheBudget(size_t a_cache_budget) {
+    this->cache_budget = a_cache_budget;
+    return;
+}
+
+MatchContext& MatchContext::GetThreadContext(size_t a_cache_budget) {
+    thread_local MatchContext context;
+    context.SetDFACacheBudget(a_cache_budget);
+    return context;
+}
+
+LazyDFA& MatchContext::GetLazyDFA(const shared_ptr<const void>& a_program, bool is_unanchored,
+                                  LazyDFA::Counters& before) {
+    auto it = this->dfa_caches.begin();
+    while(it != this->dfa_caches.end() && it->program.get() != a_program.get()) ++it;
+    if(it == this->dfa_caches.end()) {
+        if(this->dfa_caches.size() < kMaxDFACaches) this->dfa_caches.emplace_back();
+        it = std::prev(this->dfa_caches.end());
+    }
+    this->dfa_caches.splice(this->dfa_caches.begin(), this->dfa_caches, it);
+
+    //A cache taken over from another program only holds its states.
+    DFACache& cache = this->dfa_caches.front();
+    before = cache.lazy_dfa.GetCounters();
+    if(cache.program.get() != a_program.get()) {
+        cache.program = a_program;
+        cache.lazy_dfa = LazyDFA(this->cache_budget, is_unanchored);
+    }
+    if(cache.lazy_dfa.GetCacheBudget() != this->cache_budget) cache.lazy_dfa.SetCacheBudget(this->cache_budget);
+    return cache.lazy_dfa;
+}
+
+size_t MatchContext::ReserveSteps(size_t state_count, size_t steps) {
+    if(this->marks.size() < state_count) this->marks.resize(state_count, 0);
+    size_t first = this->last_step + 1;
+    this->last_step += steps;
+    return first;
+}
+
+//END OF MATCHCONTEXT CLASS IMPLEMENTATION
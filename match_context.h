@@ -0,0 +1,107 @@
+#pragma once
+
+/*
+ * Filename: match_context.h
+ * Programmer: Abdurrahman Alyajouri
+ * Date: 10/17/2026
+ * Purpose: The purpose of this file is to define the MatchContext class, the
+ *          scratch space of Regex::Match, Regex::Find and the group
+ *          searches. It holds the state lists and capture slots the NFA
+ *          simulations work on and a lazy DFA state cache of its own. The buffers are sized to the automaton on first use and
+ *          reused afterwards, so once they have grown, matching with the same
+ *          context allocates nothing. The lazy DFA caches of the last few
+ *          programs matched are kept side by side, so a context can go back
+ *          and forth between patterns without rebuilding them. A const Regex
+ *          can be shared by any number of threads without locks, as long as
+ *          each thread passes a MatchContext of its own.
+ */
+
+#include "lazy_dfa.h"
+#include "pike_vm.h"
+#include "tnfa.h"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <vector>
+
+using std::list;
+using std::shared_ptr;
+using std::size_t;
+using std::vector;
+
+class MatchContext {
+    public:
+        //Most programs a context keeps a lazy DFA cache for. Matching
+        //another one takes over the cache of the least recently used.
+        static constexpr size_t kMaxDFACaches = 16;
+
+        //Ctors. The second one sets the memory budget of each lazy DFA's
+        //state cache, in bytes. Copying a context only copies that budget,
+        //like copying a LazyDFA, the copy starts out cold.
+        MatchContext();
+        explicit MatchContext(size_t a_cache_budget);
+        MatchContext(const MatchContext& a_context);
+        MatchContext& operator=(const MatchContext& a_context);
+
+        //Get and set the memory budget of each lazy DFA's state cache. A
+        //cache is flushed the next time it is used after the budget
+        //changed.
+        size_t GetDFACacheBudget(void) const;
+        void SetDFACacheBudget(size_t a_cache_budget);
+
+    private:
+        //Fill the buffers in.
+        friend class Regex;
+        friend class RegexSet;
+
+        //Returns the calling thread's context, for the calls not given
+        //one, with its cache budget set to "a_cache_budget". Every Regex
+        //and RegexSet on the thread shares it.
+        static MatchContext& GetThreadContext(size_t a_cache_budget);
+
+        //A thread of the unanchored search: an NFA state reached by a match
+        //attempt that began at input offset "start".
+        struct Thread {
+            StateId state;
+            size_t start;
+        };
+
+        //Makes sure "marks" covers "state_count" states, and returns the
+        //first of "steps" unused mark values, which are reserved for the
+        //caller. Marks never need clearing, since later calls use larger
+        //values.
+        size_t ReserveSteps(size_t state_count, size_t steps);
+
+        //A lazy DFA and the compiled program it caches the states of.
+        //Holding on to the program keeps its address from being reused by
+        //another program.
+        struct DFACache {
+            shared_ptr<const void> program;
+            LazyDFA lazy_dfa;
+        };
+
+        //Returns the lazy DFA of "a_program", with the current budget, and
+        //makes it the most recently used. "a_program" identifies the
+        //automaton, which is unanchored if "is_unanchored". "before" is set
+        //to the DFA's counters ahead of any flush this takes, so the stats
+        //count those too.
+        LazyDFA& GetLazyDFA(const shared_ptr<const void>& a_program, bool is_unanchored, LazyDFA::Counters& before);
+
+        size_t cache_budget; //Of each lazy DFA.
+        list<DFACache> dfa_caches; //Most recently used first.
+
+        vector<std::uint32_t> current_states; //Active states of a Match.
+        vector<std::uint32_t> next_states;
+        vector<Thread> current_threads; //Active threads of a Find.
+        vector<Thread> next_threads;
+        vector<StateId> pending; //Stack of the epsilon walks.
+
+        //A state is in the list being built if its mark equals the step
+        //the list is for.
+        vector<size_t> marks;
+        size_t last_step; //Largest mark value handed out so far.
+
+        PikeVM::Scratch pike_vm_scratch; //Buffers of FindGroups and MatchGroups.
+        vector<size_t> group_slots; //Capture slots of their match.
+};
@@ -0,0 +1,151 @@
+/*
+ * Filename: pike_vm.cpp
+ * Programmer: Abdurrahman Alyajouri
+ * Date: 10/17/2026
+ * Purpose: The purpose of this file is to implement the PikeVM class
+ *          declared in "pike_vm.h".
+ */
+
+#include "pike_vm.h"
+#include <algorithm>
+#include <vector>
+
+using std::vector;
+
+//BEGINNING OF PIKEVM CLASS IMPLEMENTATION
+
+PikeVM::PikeVM() : slot_count(2) {}
+
+PikeVM::PikeVM(const TNFA& nfa, size_t group_count) : slot_count(2 * (group_count + 1)) {
+    const vector<CaptureMarker>& markers = nfa.GetCaptureMarkers();
+    if(markers.empty()) return;
+
+    this->state_slots.assign(nfa.GetStateCount(), -1);
+    for(const CaptureMarker& marker : markers)
+        this->state_slots[marker.state] = static_cast<std::int32_t>(marker.slot);
+}
+
+size_t PikeVM::GetGroupCount(void) const {
+    return this->slot_count / 2 - 1;
+}
+
+size_t PikeVM::GetMemoryUsage(void) const {
+    return sizeof(PikeVM) + this->state_slots.capacity() * sizeof(std::int32_t);
+}
+
+bool PikeVM::Search(const TNFA& nfa, string_view input, size_t pos, bool anchored,
+                    vector<size_t>& slots, Scratch& scratch) const {
+    if(nfa.IsEmpty() || pos > input.size()) return false;
+
+    //Every buffer is reserved for the worst case up front, so the search
+    //does no allocations once it is running, and none at all once the
+    //scratch has grown. The slots of a thread are appended when it is
+    //added, so they needn't be cleared.
+    size_t state_count = nfa.GetStateCount();
+    scratch.current_states.reserve(state_count);
+    scratch.next_states.reserve(state_count);
+    scratch.current_slots.reserve(state_count * this->slot_count);
+    scratch.next_slots.reserve(state_count * this->slot_count);
+    if(scratch.marks.size() < state_count) scratch.marks.resize(state_count, 0);
+    scratch.slots.assign(this->slot_count, kUnset);
+    scratch.stack.reserve(3 * state_count + 1);
+    scratch.next_states.clear();
+    scratch.next_slots.clear();
+    ++scratch.step;
+
+    bool found = false;
+    slots.assign(this->slot_count, kUnset);
+
+    scratch.slots[0] = pos;
+    AddThread(nfa, scratch, nfa.GetStartState(), pos);
+    scratch.current_states.swap(scratch.next_states);
+    scratch.current_slots.swap(scratch.next_slots);
+
+    for(size_t i = pos; ; ++i) {
+        vector<StateId>& current_states = scratch.current_states;
+        if(!anchored || i == input.size()) {
+            for(size_t j = 0; j < current_states.size(); ++j) {
+                if(!nfa.GetState(current_states[j]).acceptance) continue;
+
+                //Prefer the leftmost, then the longest match. Among matches
+                //of the same span, the thread with the highest priority
+                //reaches the accept state first.
+                const size_t* thread_slots = &scratch.current_slots[j * this->slot_count];
+                size_t start = thread_slots[0];
+                if(!found || start < slots[0] || (start == slots[0] && i > slots[1])) {
+                    std::copy(thread_slots, thread_slots + this->slot_count, slots.begin());
+                    slots[1] = i;
+                    found = true;
+                }
+
+                //Attempts that began later can't beat this match anymore.
+                size_t k = j + 1;
+                while(k < current_states.size() && scratch.current_slots[k * this->slot_count] == start) ++k;
+                current_states.resize(k);
+                break;
+            }
+        }
+
+        if(i == input.size() || (current_states.empty() && (found || anchored))) break;
+
+        //Advance every thread over the next input symbol, in priority order.
+        ++scratch.step;
+        scratch.next_states.clear();
+        scratch.next_slots.clear();
+        for(size_t j = 0; j < current_states.size(); ++j) {
+            const State& state = nfa.GetState(current_states[j]);
+            if(!state.Matches(input[i])) continue;
+            const size_t* thread_slots = &scratch.current_slots[j * this->slot_count];
+            std::copy(thread_slots, thread_slots + this->slot_count, scratch.slots.begin());
+            AddThread(nfa, scratch, state.symbol_transition, i + 1);
+        }
+
+        //Keep looking for a starting offset until something matched. New
+        //attempts have the lowest priority.
+        if(!anchored && !found) {
+            std::fill(scratch.slots.begin(), scratch.slots.end(), kUnset);
+            scratch.slots[0] = i + 1;
+            AddThread(nfa, scratch, nfa.GetStartState(), i + 1);
+        }
+
+        scratch.current_states.swap(scratch.next_states);
+        scratch.current_slots.swap(scratch.next_slots);
+    }
+
+    return found;
+}
+
+void PikeVM::AddThread(const TNFA& nfa, Scratch& scratch, StateId state, size_t offset) const {
+    //Walk the epsilon transitions depth first, taking the first one first,
+    //so that states are added in the order of their priority. Slots set
+    //by a marker are restored once the walk leaves it.
+    scratch.stack.push_back({state, 0, 0});
+    while(!scratch.stack.empty()) {
+        Frame frame = scratch.stack.back();
+        scratch.stack.pop_back();
+        if(frame.state == kNoState) {
+            scratch.slots[frame.slot] = frame.offset;
+            continue;
+        }
+        if(scratch.marks[frame.state] == scratch.step) continue;
+        scratch.marks[frame.state] = scratch.step;
+
+        if(!this->state_slots.empty() && this->state_slots[frame.state] >= 0) {
+            std::uint32_t slot = static_cast<std::uint32_t>(this->state_slots[frame.state]);
+            scratch.stack.push_back({kNoState, slot, scratch.slots[slot]});
+            scratch.slots[slot] = offset;
+        }
+
+        const State& current = nfa.GetState(frame.state);
+        if(current.HasSymbolTransition() || current.acceptance) {
+            scratch.next_states.push_back(frame.state);
+            scratch.next_slots.insert(scratch.next_slots.end(), scratch.slots.begin(), scratch.slots.end());
+        }
+
+        for(int i = current.epsilon_count - 1; i >= 0; --i)
+            scratch.stack.push_back({current.epsilon_transitions[i], 0, 0});
+    }
+    return;
+}
+
+//END OF PIKEVM CLASS IMPLEMENTATION
@@ -0,0 +1,95 @@
+#pragma once
+
+/*
+ * Filename: pike_vm.h
+ * Programmer: Abdurrahman Alyajouri
+ * Date: 10/17/2026
+ * Purpose: The purpose of this file is to define the PikeVM class, which
+ *          finds where the capture groups of a pattern matched. Like the
+ *          other simulations it runs every thread of the TNFA in lockstep
+ *          over the input, but each thread also carries the input offsets
+ *          its capture groups began and ended at. Threads are kept in
+ *          priority order and the first one to reach a state wins it, so the
+ *          search takes O(input length * states) steps no matter how
+ *          ambiguous the pattern is, and reports the groups in one pass.
+ */
+
+#include "tnfa.h"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+using std::size_t;
+using std::string_view;
+using std::vector;
+
+class PikeVM {
+    public:
+        //Value of a capture slot that was never set.
+        static constexpr size_t kUnset = static_cast<size_t>(-1);
+
+        //Ctors. The first one creates a VM for a pattern without groups.
+        //The second one reads the capture markers of "nfa", whose pattern
+        //has "group_count" groups. Groups may have no markers, e.g. if
+        //they were repeated zero times.
+        PikeVM();
+        PikeVM(const TNFA& nfa, size_t group_count);
+
+        //Returns the number of capture groups, not counting group 0, the
+        //whole match.
+        size_t GetGroupCount(void) const;
+
+        //Returns an estimate of the memory the VM uses, in bytes.
+        size_t GetMemoryUsage(void) const;
+
+        //A step of the epsilon walk in AddThread: either a state to visit,
+        //or, if "state" is kNoState, a capture slot to restore to "offset"
+        //once every state reachable through the marker was visited.
+        struct Frame {
+            StateId state;
+            std::uint32_t slot;
+            size_t offset;
+        };
+
+        //The buffers of a search, kept by the caller so they are only
+        //allocated the first time, e.g. in a MatchContext. A state is in
+        //"next_states" if its entry in "marks" equals "step". Marks never
+        //need clearing, since every search uses larger steps.
+        struct Scratch {
+            vector<StateId> current_states;
+            vector<StateId> next_states;
+            vector<size_t> current_slots; //"slot_count" slots per thread.
+            vector<size_t> next_slots;
+            vector<size_t> marks;
+            vector<size_t> slots; //Slots of the thread being added.
+            vector<Frame> stack;
+            size_t step = 0;
+        };
+
+        //Searches "input" for the leftmost match that starts at or after
+        //"pos", preferring the longest one, like Regex::Find. If "anchored",
+        //the match must start at "pos" and end at the end of the input.
+        //"nfa" must be the TNFA the VM was built from. On a match, "slots"
+        //receives 2 * (GetGroupCount() + 1) offsets: where each group began
+        //and ended, kUnset for groups that took no part in the match. When
+        //a group matched more than once, the last time is reported, and
+        //when the match could be split up in several ways, the split that
+        //prefers earlier alternatives and longer repetitions is reported.
+        //The search works in "scratch", which may have been used by any VM
+        //before.
+        bool Search(const TNFA& nfa, string_view input, size_t pos, bool anchored,
+                    vector<size_t>& slots, Scratch& scratch) const;
+
+    private:
+
+        //Adds "state" and every state reachable from it via epsilon
+        //transitions to "next_states", in priority order, unless they are
+        //in it already. Capture markers passed on the way record "offset"
+        //in "scratch.slots", and the states that consume a byte or accept
+        //get a copy of the slots.
+        void AddThread(const TNFA& nfa, Scratch& scratch, StateId state, size_t offset) const;
+
+        vector<std::int32_t> state_slots; //Slot each state records, or -1.
+        size_t slot_count; //Two per group, including group 0.
+};
@@ -0,0 +1,77 @@
+/*
+ * Filename: prefilter.cpp
+ * Programmer: Abdurrahman Alyajouri
+ * Date: 10/17/2026
+ * Purpose: The purpose of this file is to implement the Prefilter class
+ *          declared in "prefilter.h".
+ */
+
+#include "prefilter.h"
+#include <cstring>
+#include <string>
+
+using std::string;
+
+//BEGINNING OF PREFILTER CLASS IMPLEMENTATION
+
+Prefilter::Prefilter() : max_offset(0), rare_index(0) {}
+
+Prefilter::Prefilter(const string& literal, size_t max_offset) : literal(literal), max_offset(max_offset), rare_index(0) {
+    //memchr looks for the rarest byte, so fewer candidates need checking.
+    for(size_t i = 1; i < this->literal.size(); ++i) {
+        if(GetByteRank(static_cast<unsigned char>(this->literal[i])) <
+           GetByteRank(static_cast<unsigned char>(this->literal[this->rare_index])))
+            this->rare_index = i;
+    }
+}
+
+bool Prefilter::IsBuilt(void) const {
+    return !this->literal.empty();
+}
+
+const string& Prefilter::GetLiteral(void) const {
+    return this->literal;
+}
+
+size_t Prefilter::GetMaxOffset(void) const {
+    return this->max_offset;
+}
+
+size_t Prefilter::Find(string_view input, size_t pos) const {
+    size_t length = this->literal.size();
+    if(length == 0 || pos > input.size() || input.size() - pos < length) return string_view::npos;
+
+    //Candidates are where the rare byte is, checked against the whole
+    //literal. The last one starts "length" bytes before the end.
+    const char* data = input.data();
+    const char rare = this->literal[this->rare_index];
+    size_t candidate = pos;
+    size_t last = input.size() - length;
+    while(candidate <= last) {
+        const void* hit = std::memchr(data + candidate + this->rare_index, rare, last - candidate + 1);
+        if(hit == nullptr) break;
+        candidate = static_cast<const char*>(hit) - data - this->rare_index;
+        if(std::memcmp(data + candidate, this->literal.data(), length) == 0) return candidate;
+        ++candidate;
+    }
+    return string_view::npos;
+}
+
+size_t Prefilter::GetEarliestStart(size_t pos, size_t hit) const {
+    if(this->max_offset == kUnbounded || hit - pos <= this->max_offset) return pos;
+    return hit - this->max_offset;
+}
+
+int Prefilter::GetByteRank(unsigned char c) {
+    //A rough order of byte frequencies in text, source code and logs.
+    if(c == ' ') return 9;
+    if(std::strchr("etaoinsrhl", c) != nullptr && c != '\0') return 8;
+    if(c >= 'a' && c <= 'z') return 7;
+    if(c >= '0' && c <= '9') return 6;
+    if(c >= 'A' && c <= 'Z') return 5;
+    if(std::strchr(".,-_/:=\"'()\n\t", c) != nullptr && c != '\0') return 4;
+    if(c >= 0x20 && c < 0x7F) return 3;
+    return c == '\0' ? 2 : 1;
+}
+
+//END OF PREFILTER CLASS IMPLEMENTATION
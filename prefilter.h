@@ -0,0 +1,60 @@
+#pragma once
+
+/*
+ * Filename: prefilter.h
+ * Programmer: Abdurrahman Alyajouri
+ * Date: 10/17/2026
+ * Purpose: The purpose of this file is to define the Prefilter class, which
+ *          looks for a literal that every match of a pattern contains, like
+ *          " World" in "((Hello)|(Hi)) Worlds*". Searching for the literal
+ *          with memchr, which the C library vectorizes, is much faster than
+ *          running an automaton over every byte, so an unanchored search can
+ *          skip straight to the parts of the input where a match may be.
+ */
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+using std::size_t;
+using std::string;
+using std::string_view;
+
+class Prefilter {
+    public:
+        //Offset of a literal that can be arbitrarily far into a match.
+        static constexpr size_t kUnbounded = static_cast<size_t>(-1);
+
+        //Longest literal worth searching for. Longer ones are cut short,
+        //since a few bytes already make false candidates rare.
+        static constexpr size_t kMaxLength = 64;
+
+        //Ctors. The first one creates an empty prefilter that can't be used.
+        //The second one searches for "literal", which starts at most
+        //"max_offset" bytes into every match, or anywhere if kUnbounded.
+        Prefilter();
+        Prefilter(const string& literal, size_t max_offset);
+
+        //Returns true if the prefilter has a literal and may be used.
+        bool IsBuilt(void) const;
+
+        //Getters.
+        const string& GetLiteral(void) const;
+        size_t GetMaxOffset(void) const;
+
+        //Returns the offset of the first occurrence of the literal in
+        //"input" at or after "pos", or string_view::npos if there is none.
+        size_t Find(string_view input, size_t pos) const;
+
+        //Returns the offset a match must start at or after, given that the
+        //first occurrence of the literal at or after "pos" is at "hit".
+        size_t GetEarliestStart(size_t pos, size_t hit) const;
+
+    private:
+        //Ranks how common a byte is in typical text, lower is rarer.
+        static int GetByteRank(unsigned char c);
+
+        string literal; //Empty if not built.
+        size_t max_offset;
+        size_t rare_index; //Index of the rarest byte of "literal", which memchr looks for.
+};
@@ -7,30 +7,40 @@
  */
 
 #include "regex.h"
+#include "regex_cache.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
 #include <iostream>
+#include <stdexcept>
 #include <string>
 #include <stack>
-#include <unordered_map>
-#include <unordered_set>
+#include <utility>
+#include <vector>
 
 using std::string;
 using std::stack;
-using std::unordered_map;
-using std::unordered_set;
+using std::vector;
 
 //BEGINNING OF REGEX CLASS IMPLEMENTATION
 
-Regex::Regex() {}
+Regex::Regex() {
+    //An empty NFA, which matches nothing, shared by every default Regex.
+    static const shared_ptr<const Program> empty_program = std::make_shared<const Program>();
+    this->program = empty_program;
+}
 
 Regex::Regex(const string& a_pattern) {
     this->pattern = a_pattern;
-    DoThompsonsConstruction(a_pattern);
+    this->program = RegexCache::GetGlobal().Get(a_pattern);
 }
 
 Regex& Regex::operator=(const string& a_pattern) {
+    //Leaves the invoking Regex untouched if the pattern is malformed.
+    shared_ptr<const Program> a_program = RegexCache::GetGlobal().Get(a_pattern);
+    this->program = std::move(a_program);
     this->pattern = a_pattern;
-    this->nfa.Clear();
-    DoThompsonsConstruction(a_pattern);
+    this->counters.Reset();
     return *this;
 }
 
@@ -38,123 +48,1576 @@ string Regex::GetPattern(void) const {
     return this->pattern;
 }
 
-bool Regex::Match(const string& input) const {
-    //Will hold the set of states the nfa is currently in at any moment.
-    unordered_set<State*> current_states; 
-                                        
-    //Get all states the nfa will be in simultaneously at the start.
-    GetEpsilonClosure(this->nfa.GetStartState(), current_states);
+bool Regex::Match(string_view input) const {
+    return Match(input, MatchContext::GetThreadContext(this->cache_budget));
+}
+
+bool Regex::Match(string_view input, MatchContext& context) const {
+    const Program& compiled = *this->program;
+    this->counters.Add(RegexCounters::kMatchCalls, 1);
+    this->counters.Add(RegexCounters::kBytesScanned, input.size());
+    if(compiled.literals.IsBuilt()) {
+        this->counters.Add(RegexCounters::kLiteralMatches, 1);
+        return compiled.literals.Match(input);
+    }
+    if(compiled.bit_parallel.IsBuilt()) {
+        this->counters.Add(RegexCounters::kBitParallelMatches, 1);
+        return compiled.bit_parallel.Match(input);
+    }
+    
+    LazyDFA::Counters before;
+    LazyDFA& lazy_dfa = context.GetLazyDFA(this->program, false, before);
+    LazyDFA::Result result = lazy_dfa.Match(compiled.nfa, compiled.byte_classes, input);
+    if constexpr(kRegexStatsEnabled) {
+        const LazyDFA::Counters& after = lazy_dfa.GetCounters();
+        this->counters.Add(RegexCounters::kDFALookups, after.lookups - before.lookups);
+        this->counters.Add(RegexCounters::kDFAMisses, after.misses - before.misses);
+        this->counters.Add(RegexCounters::kDFAFlushes, after.flushes - before.flushes);
+    }
+    if(result != LazyDFA::Result::kGaveUp) {
+        this->counters.Add(RegexCounters::kDFAMatches, 1);
+        return result == LazyDFA::Result::kMatch;
+    }
+    this->counters.Add(RegexCounters::kNFAMatches, 1);
+    if(compiled.epsilon_free.IsBuilt()) return MatchEpsilonFree(input, context);
+    return MatchNFA(input, context);
+}
+
+optional<RegexMatch> Regex::Find(string_view input, size_t pos) const {
+    return Find(input, MatchContext::GetThreadContext(this->cache_budget), pos);
+}
+
+optional<RegexMatch> Regex::Find(string_view input, MatchContext& context, size_t pos) const {
+    if(this->program->nfa.IsEmpty() || pos > input.size()) return std::nullopt;
+    if(this->program->literals.IsBuilt()) {
+        //A literal all of the alternatives share is found with memchr,
+        //which is a lot faster than walking the automaton up to it.
+        const Prefilter& prefilter = this->program->prefilter;
+        size_t start = pos;
+        if(prefilter.IsBuilt()) {
+            size_t hit = prefilter.Find(input, pos);
+            if(hit == string_view::npos) {
+                this->counters.Add(RegexCounters::kFindCalls, 1);
+                this->counters.Add(RegexCounters::kBytesSkipped, input.size() - pos);
+                return std::nullopt;
+            }
+            start = prefilter.GetEarliestStart(pos, hit);
+            this->counters.Add(RegexCounters::kBytesSkipped, start - pos);
+        }
+        size_t begin = 0;
+        size_t end = 0;
+        bool found = this->program->literals.Find(input, start, begin, end);
+        this->counters.Add(RegexCounters::kFindCalls, 1);
+        this->counters.Add(RegexCounters::kBytesScanned, (found ? end : input.size()) - start);
+        if(!found) return std::nullopt;
+        return RegexMatch{begin, end};
+    }
+    if(this->program->epsilon_free.IsBuilt()) return FindEpsilonFree(input, pos, context);
     
-    unordered_set<State*> closure;
+    //Threads are kept ordered by the offset their attempt began at, so that
+    //when two attempts reach the same state the leftmost one wins. A new
+    //attempt is started behind the others at every offset, which searches
+    //all starting offsets in a single pass over the input. The thread list
+    //at offset i is built in step "base + i - pos + 1".
+    vector<Thread>& current_threads = context.current_threads;
+    vector<Thread>& next_threads = context.next_threads;
+    vector<size_t>& marks = context.marks;
+    size_t base = context.ReserveSteps(this->program->nfa.GetStateCount(), input.size() - pos + 1) - 1;
+    current_threads.clear();
+    optional<RegexMatch> best;
+    
+    //Counted locally and added to "counters" once, at the end.
+    size_t steps = 0;
+    size_t skipped = 0;
+    size_t active_states = 0;
+    size_t max_active_states = 0;
+    size_t expansions = AddThread(current_threads, marks, base + 1, this->program->nfa.GetStartState(), pos,
+                                  context.pending);
+    
+    const Prefilter& prefilter = this->program->prefilter;
+    size_t hit = 0;
+    bool hit_known = false;
+    for(size_t i = pos; ; ++i) {
+        //While the only attempt under way is the one that starts here, no
+        //match can start before the required literal allows, and there is
+        //none at all once the literal doesn't occur anymore.
+        if(prefilter.IsBuilt() && !best && (current_threads.empty() || current_threads[0].start == i)) {
+            if(!hit_known || hit < i) {
+                hit = prefilter.Find(input, i);
+                hit_known = true;
+            }
+            if(hit == string_view::npos) break;
+            size_t start = prefilter.GetEarliestStart(i, hit);
+            if(start > i) {
+                skipped += start - i;
+                i = start;
+                current_threads.clear();
+                expansions += AddThread(current_threads, marks, base + i - pos + 1,
+                                        this->program->nfa.GetStartState(), i, context.pending);
+            }
+        }
+        
+        for(size_t j = 0; j < current_threads.size(); ++j) {
+            const Thread& thread = current_threads[j];
+            if(!this->program->nfa.GetState(thread.state).acceptance) continue;
+            
+            //Prefer the leftmost, then the longest match.
+            if(!best || thread.start < best->begin || 
+               (thread.start == best->begin && i > best->end))
+                best = RegexMatch{thread.start, i};
+            
+            //Attempts that began later can't beat this match anymore.
+            size_t k = j + 1;
+            while(k < current_threads.size() && current_threads[k].start == thread.start) ++k;
+            current_threads.resize(k);
+            break;
+        }
+        
+        if(i == input.size() || (best && current_threads.empty())) break;
+        
+        //Advance every thread over the next input symbol.
+        size_t step = base + i - pos + 2;
+        if constexpr(kRegexStatsEnabled) {
+            ++steps;
+            active_states += current_threads.size();
+            max_active_states = std::max(max_active_states, current_threads.size());
+        }
+        next_threads.clear();
+        for(const Thread& thread : current_threads) {
+            const State& state = this->program->nfa.GetState(thread.state);
+            if(state.Matches(input[i]))
+                expansions += AddThread(next_threads, marks, step, state.symbol_transition, thread.start,
+                                        context.pending);
+        }
+        
+        //Keep looking for a starting offset until something matched.
+        if(!best)
+            expansions += AddThread(next_threads, marks, step, this->program->nfa.GetStartState(), i + 1,
+                                    context.pending);
+        
+        current_threads.swap(next_threads);
+    }
+    
+    this->counters.Add(RegexCounters::kFindCalls, 1);
+    this->counters.Add(RegexCounters::kBytesScanned, steps);
+    this->counters.Add(RegexCounters::kBytesSkipped, skipped);
+    this->counters.Add(RegexCounters::kNFASteps, steps);
+    this->counters.Add(RegexCounters::kActiveStates, active_states);
+    this->counters.Max(RegexCounters::kMaxActiveStates, max_active_states);
+    this->counters.Add(RegexCounters::kClosureExpansions, expansions);
+    return best;
+}
+
+vector<RegexMatch> Regex::FindAll(string_view input) const {
+    vector<RegexMatch> matches;
+    MatchContext& scratch = MatchContext::GetThreadContext(this->cache_budget);
+    size_t pos = 0;
+    while(pos <= input.size()) {
+        optional<RegexMatch> match = Find(input, scratch, pos);
+        if(!match) break;
+        
+        //Skip empty matches that touch the previous match.
+        if(match->begin == match->end && !matches.empty() && matches.back().end == match->begin) {
+            pos = match->begin + 1;
+            continue;
+        }
+        
+        matches.push_back(*match);
+        pos = match->end > match->begin ? match->end : match->end + 1;
+    }
+    return matches;
+}
+
+size_t Regex::GetGroupCount(void) const {
+    return this->program->pike_vm.GetGroupCount();
+}
+
+bool Regex::CanContainByte(unsigned char c) const {
+    const TNFA& nfa = this->program->nfa;
+    for(StateId id = 0; id < nfa.GetStateCount(); ++id) {
+        if(nfa.GetState(id).Matches(static_cast<char>(c))) return true;
+    }
+    return false;
+}
+
+bool Regex::FindGroups(string_view input, vector<optional<RegexMatch>>& groups, size_t pos) const {
+    return SearchGroups(input, pos, false, groups, MatchContext::GetThreadContext(this->cache_budget));
+}
+
+bool Regex::FindGroups(string_view input, vector<optional<RegexMatch>>& groups, MatchContext& context,
+                       size_t pos) const {
+    return SearchGroups(input, pos, false, groups, context);
+}
+
+bool Regex::MatchGroups(string_view input, vector<optional<RegexMatch>>& groups) const {
+    return SearchGroups(input, 0, true, groups, MatchContext::GetThreadContext(this->cache_budget));
+}
+
+bool Regex::MatchGroups(string_view input, vector<optional<RegexMatch>>& groups, MatchContext& context) const {
+    return SearchGroups(input, 0, true, groups, context);
+}
+
+bool Regex::SearchGroups(string_view input, size_t pos, bool anchored,
+                         vector<optional<RegexMatch>>& groups, MatchContext& context) const {
+    groups.assign(GetGroupCount() + 1, std::nullopt);
+    vector<size_t>& slots = context.group_slots;
+    const TNFA& nfa = this->program->group_nfa.IsEmpty() ? this->program->nfa : this->program->group_nfa;
+    if(!this->program->pike_vm.Search(nfa, input, pos, anchored, slots, context.pike_vm_scratch)) return false;
+    
+    for(size_t k = 0; k < groups.size(); ++k)
+        if(slots[2 * k] != PikeVM::kUnset) groups[k] = RegexMatch{slots[2 * k], slots[2 * k + 1]};
+    return true;
+}
+
+size_t Regex::GetDFACacheBudget(void) const {
+    return this->cache_budget;
+}
+
+void Regex::SetDFACacheBudget(size_t a_cache_budget) {
+    this->cache_budget = a_cache_budget;
+    return;
+}
+
+RegexStats Regex::GetStats(void) const {
+    RegexStats stats{};
+    const TNFA& nfa = this->program->nfa;
+    stats.nfa_states = nfa.GetStateCount();
+    for(StateId id = 0; id < nfa.GetStateCount(); ++id) {
+        const State& state = nfa.GetState(id);
+        stats.nfa_symbol_edges += state.HasSymbolTransition();
+        stats.nfa_epsilon_edges += state.epsilon_count;
+    }
+    stats.epsilon_free_states = this->program->epsilon_free.GetStateCount();
+    stats.epsilon_free_edges = this->program->epsilon_free.GetEdgeCount();
+    stats.glushkov_positions = this->program->bit_parallel.GetPositionCount();
+    stats.literal_states = this->program->literals.GetStateCount();
+    stats.required_literal_length = this->program->prefilter.GetLiteral().size();
+    stats.construction_us = this->program->construction_us;
+    stats.unsimplified_nfa_states = this->program->unsimplified_states;
+    
+    stats.match_calls = this->counters.Get(RegexCounters::kMatchCalls);
+    stats.find_calls = this->counters.Get(RegexCounters::kFindCalls);
+    stats.bytes_scanned = this->counters.Get(RegexCounters::kBytesScanned);
+    stats.bytes_skipped = this->counters.Get(RegexCounters::kBytesSkipped);
+    stats.literal_matches = this->counters.Get(RegexCounters::kLiteralMatches);
+    stats.bit_parallel_matches = this->counters.Get(RegexCounters::kBitParallelMatches);
+    stats.dfa_matches = this->counters.Get(RegexCounters::kDFAMatches);
+    stats.nfa_matches = this->counters.Get(RegexCounters::kNFAMatches);
+    stats.nfa_steps = this->counters.Get(RegexCounters::kNFASteps);
+    stats.active_states = this->counters.Get(RegexCounters::kActiveStates);
+    stats.max_active_states = this->counters.Get(RegexCounters::kMaxActiveStates);
+    stats.closure_expansions = this->counters.Get(RegexCounters::kClosureExpansions);
+    
+    stats.dfa_cache_misses = this->counters.Get(RegexCounters::kDFAMisses);
+    stats.dfa_cache_hits = this->counters.Get(RegexCounters::kDFALookups) - stats.dfa_cache_misses;
+    stats.dfa_cache_flushes = this->counters.Get(RegexCounters::kDFAFlushes);
+    return stats;
+}
+
+void Regex::ResetStats(void) {
+    this->counters.Reset();
+    return;
+}
+
+bool Regex::MatchNFA(string_view input, MatchContext& context) const {
+    const TNFA& nfa = this->program->nfa;
+    if(nfa.IsEmpty()) return false;
+    
+    //Same as Find, with a single attempt that starts at the beginning.
+    vector<Thread>& current_threads = context.current_threads;
+    vector<Thread>& next_threads = context.next_threads;
+    size_t step = context.ReserveSteps(nfa.GetStateCount(), input.size() + 1);
+    current_threads.clear();
+    
+    //Counted locally and added to "counters" once, at the end.
+    size_t steps = 0;
+    size_t active_states = 0;
+    size_t max_active_states = 0;
+    size_t expansions = AddThread(current_threads, context.marks, step, nfa.GetStartState(), 0, context.pending);
     
     for(char c : input) {
-        for(State* state : current_states)
-            if(state->symbol_transitions.count(c) > 0)
-                for(State* next_state : state->symbol_transitions.at(c))
-                    GetEpsilonClosure(next_state, closure);
-                    
-        current_states = closure;  
-        closure.clear();  
+        if constexpr(kRegexStatsEnabled) {
+            ++steps;
+            active_states += current_threads.size();
+            max_active_states = std::max(max_active_states, current_threads.size());
+        }
+        ++step;
+        next_threads.clear();
+        for(const Thread& thread : current_threads) {
+            const State& state = nfa.GetState(thread.state);
+            if(state.Matches(c))
+                expansions += AddThread(next_threads, context.marks, step, state.symbol_transition, 0, context.pending);
+        }
+        current_threads.swap(next_threads);
+        if(current_threads.empty()) break;
     }
     
-    for(State* state : current_states) if(state->acceptance) return true;
+    this->counters.Add(RegexCounters::kNFASteps, steps);
+    this->counters.Add(RegexCounters::kActiveStates, active_states);
+    this->counters.Max(RegexCounters::kMaxActiveStates, max_active_states);
+    this->counters.Add(RegexCounters::kClosureExpansions, expansions);
+    
+    for(const Thread& thread : current_threads) if(nfa.GetState(thread.state).acceptance) return true;
+    return false;
+}
+
+bool Regex::MatchEpsilonFree(string_view input, MatchContext& context) const {
+    const EpsilonFreeNFA& nfa = this->program->epsilon_free;
+    
+    //The active states, without duplicates. A state is in "next_states"
+    //if its entry in "marks" equals "step".
+    vector<std::uint32_t>& current_states = context.current_states;
+    vector<std::uint32_t>& next_states = context.next_states;
+    vector<size_t>& marks = context.marks;
+    size_t step = context.ReserveSteps(nfa.GetStateCount(), input.size()) - 1;
+    size_t base = step;
+    current_states.clear();
+    for(std::uint32_t id : nfa.GetStartStates()) current_states.push_back(id);
+    
+    //Counted locally and added to "counters" once, at the end.
+    size_t active_states = 0;
+    size_t max_active_states = 0;
+    size_t expansions = current_states.size();
+    
+    for(char c : input) {
+        if constexpr(kRegexStatsEnabled) {
+            active_states += current_states.size();
+            max_active_states = std::max(max_active_states, current_states.size());
+        }
+        ++step;
+        next_states.clear();
+        for(std::uint32_t id : current_states) {
+            if(!nfa.GetState(id).Matches(c)) continue;
+            for(std::uint32_t next_state : nfa.GetSuccessors(id)) {
+                if(marks[next_state] == step) continue;
+                marks[next_state] = step;
+                next_states.push_back(next_state);
+            }
+        }
         
+        if constexpr(kRegexStatsEnabled) expansions += next_states.size();
+        current_states.swap(next_states);
+        if(current_states.empty()) break;
+    }
+    
+    this->counters.Add(RegexCounters::kNFASteps, step - base);
+    this->counters.Add(RegexCounters::kActiveStates, active_states);
+    this->counters.Max(RegexCounters::kMaxActiveStates, max_active_states);
+    this->counters.Add(RegexCounters::kClosureExpansions, expansions);
+    
+    for(std::uint32_t id : current_states) if(nfa.GetState(id).acceptance) return true;
     return false;
 }
 
+optional<RegexMatch> Regex::FindEpsilonFree(string_view input, size_t pos, MatchContext& context) const {
+    const EpsilonFreeNFA& nfa = this->program->epsilon_free;
+    
+    //Same search as Find. Start states are already closed under epsilon
+    //transitions, so adding a thread is a single mark check.
+    vector<Thread>& current_threads = context.current_threads;
+    vector<Thread>& next_threads = context.next_threads;
+    vector<size_t>& marks = context.marks;
+    size_t base = context.ReserveSteps(nfa.GetStateCount(), input.size() - pos + 1) - 1;
+    current_threads.clear();
+    next_threads.clear();
+    optional<RegexMatch> best;
+    auto add_thread = [&](std::uint32_t state, size_t step, size_t start) {
+        if(marks[state] == step) return;
+        marks[state] = step;
+        next_threads.push_back({state, start});
+    };
+    
+    //Counted locally and added to "counters" once, at the end.
+    size_t steps = 0;
+    size_t skipped = 0;
+    size_t active_states = 0;
+    size_t max_active_states = 0;
+    size_t expansions = 0;
+    
+    for(std::uint32_t id : nfa.GetStartStates()) add_thread(id, base + 1, pos);
+    current_threads.swap(next_threads);
+    
+    const Prefilter& prefilter = this->program->prefilter;
+    size_t hit = 0;
+    bool hit_known = false;
+    for(size_t i = pos; ; ++i) {
+        //Skip ahead to the required literal, like Find.
+        if(prefilter.IsBuilt() && !best && (current_threads.empty() || current_threads[0].start == i)) {
+            if(!hit_known || hit < i) {
+                hit = prefilter.Find(input, i);
+                hit_known = true;
+            }
+            if(hit == string_view::npos) break;
+            size_t start = prefilter.GetEarliestStart(i, hit);
+            if(start > i) {
+                skipped += start - i;
+                i = start;
+                next_threads.clear();
+                for(std::uint32_t id : nfa.GetStartStates()) add_thread(id, base + i - pos + 1, i);
+                current_threads.swap(next_threads);
+            }
+        }
+        
+        for(size_t j = 0; j < current_threads.size(); ++j) {
+            const Thread& thread = current_threads[j];
+            if(!nfa.GetState(thread.state).acceptance) continue;
+            
+            //Prefer the leftmost, then the longest match.
+            if(!best || thread.start < best->begin || 
+               (thread.start == best->begin && i > best->end))
+                best = RegexMatch{thread.start, i};
+            
+            //Attempts that began later can't beat this match anymore.
+            size_t k = j + 1;
+            while(k < current_threads.size() && current_threads[k].start == thread.start) ++k;
+            current_threads.resize(k);
+            break;
+        }
+        
+        if(i == input.size() || (best && current_threads.empty())) break;
+        
+        //Advance every thread over the next input symbol.
+        size_t step = base + i - pos + 2;
+        if constexpr(kRegexStatsEnabled) {
+            ++steps;
+            active_states += current_threads.size();
+            max_active_states = std::max(max_active_states, current_threads.size());
+        }
+        next_threads.clear();
+        for(const Thread& thread : current_threads) {
+            if(!nfa.GetState(thread.state).Matches(input[i])) continue;
+            for(std::uint32_t next_state : nfa.GetSuccessors(thread.state))
+                add_thread(next_state, step, thread.start);
+        }
+        
+        //Keep looking for a starting offset until something matched.
+        if(!best) for(std::uint32_t id : nfa.GetStartStates()) add_thread(id, step, i + 1);
+        
+        if constexpr(kRegexStatsEnabled) expansions += next_threads.size();
+        current_threads.swap(next_threads);
+    }
+    
+    this->counters.Add(RegexCounters::kFindCalls, 1);
+    this->counters.Add(RegexCounters::kBytesScanned, steps);
+    this->counters.Add(RegexCounters::kBytesSkipped, skipped);
+    this->counters.Add(RegexCounters::kNFASteps, steps);
+    this->counters.Add(RegexCounters::kActiveStates, active_states);
+    this->counters.Max(RegexCounters::kMaxActiveStates, max_active_states);
+    this->counters.Add(RegexCounters::kClosureExpansions, expansions);
+    return best;
+}
+
+size_t Regex::AddThread(vector<Thread>& threads, vector<size_t>& marks, size_t step,
+                        StateId state, size_t start, vector<StateId>& pending) const {
+    if(marks[state] == step) return 0;
+    marks[state] = step;
+    size_t visited = 0;
+    
+    //Walk the epsilon transitions with an explicit stack. Only the states
+    //that can consume a symbol or accept are worth keeping as threads.
+    pending.assign(1, state);
+    while(!pending.empty()) {
+        StateId id = pending.back();
+        pending.pop_back();
+        const State& current = this->program->nfa.GetState(id);
+        ++visited;
+        if(current.HasSymbolTransition() || current.acceptance) threads.push_back({id, start});
+        
+        for(int i = 0; i < current.epsilon_count; ++i) {
+            StateId next_state = current.epsilon_transitions[i];
+            if(marks[next_state] != step) {
+                marks[next_state] = step;
+                pending.push_back(next_state);
+            }
+        }
+    }
+    
+    return visited;
+}
+
+size_t Regex::Program::GetMemoryUsage(void) const {
+    return sizeof(Program) + (this->nfa.GetStateCount() + this->group_nfa.GetStateCount()) * sizeof(State) +
+           this->literals.GetMemoryUsage() + this->bit_parallel.GetMemoryUsage() +
+           this->epsilon_free.GetMemoryUsage() + this->pike_vm.GetMemoryUsage();
+}
+
+shared_ptr<const Regex::Program> Regex::Compile(const string& a_pattern) {
+    std::chrono::steady_clock::time_point start;
+    if constexpr(kRegexStatsEnabled) start = std::chrono::steady_clock::now();
+    
+    auto a_program = std::make_shared<Program>();
+    vector<Token> postfix = RegexToPostFix(a_pattern);
+    
+    //Groups don't change what matches, so everything but the Pike VM runs
+    //on the simplified pattern, which leaves them out. The Pike VM needs
+    //the pattern as written to report the groups it describes.
+    bool has_groups = std::any_of(postfix.begin(), postfix.end(), [](const Token& token) {
+        return token.type == Token::Type::kCapture;
+    });
+    std::uint32_t group_count = 0;
+    if(has_groups) a_program->group_nfa = DoThompsonsConstruction(postfix, group_count);
+    vector<Token> simplified = SimplifyPostFix(postfix);
+    std::uint32_t no_groups = 0;
+    a_program->nfa = DoThompsonsConstruction(simplified, no_groups);
+    
+    vector<string> literals;
+    if(ExtractLiterals(simplified, literals)) a_program->literals = AhoCorasick(literals);
+    if(a_program->literals.IsBuilt()) a_program->prefilter = ExtractRequiredLiteral(literals);
+    else a_program->prefilter = ExtractRequiredLiteral(simplified);
+    a_program->byte_classes = a_program->nfa.GetByteClasses();
+    a_program->bit_parallel = BitParallelNFA(a_program->nfa);
+    a_program->epsilon_free = EpsilonFreeNFA(a_program->nfa);
+    if(has_groups) a_program->pike_vm = PikeVM(a_program->group_nfa, group_count);
+    else a_program->pike_vm = PikeVM(a_program->nfa, 0);
+    
+    if constexpr(kRegexStatsEnabled) {
+        std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+        a_program->construction_us = elapsed.count();
+        
+        //Outside of the timing, since only the stats need it.
+        a_program->unsimplified_states = has_groups ? a_program->group_nfa.GetStateCount() :
+                                         DoThompsonsConstruction(postfix, no_groups).GetStateCount();
+    }
+    return a_program;
+}
+
+vector<Regex::Token> Regex::Tokenize(const string& a_pattern) {
+    vector<Token> tokens;
+    tokens.reserve(a_pattern.size());
+    std::uint32_t group_count = 0;
+    size_t i = 0;
+    while(i < a_pattern.size()) {
+        Token token;
+        token.type = Token::Type::kSymbol;
+        switch(a_pattern[i]) {
+            case '|': token.type = Token::Type::kAlternation; ++i; break;
+            case '*': token.type = Token::Type::kKleeneClosure; ++i; break;
+            case '+': token.type = Token::Type::kOneOrMore; ++i; break;
+            case '?': token.type = Token::Type::kZeroOrOne; ++i; break;
+            case '{': {
+                    size_t end = ParseRepetition(a_pattern, i, token);
+                    if(end == i) {
+                        token.symbols.Add('{');
+                        ++i;
+                    } else {
+                        i = end;
+                    }
+                }
+                break;
+            case '(':
+                token.type = Token::Type::kLeftParenthesis;
+                if(a_pattern.compare(i + 1, 2, "?:") == 0) {
+                    i += 3;
+                } else {
+                    token.group = ++group_count;
+                    ++i;
+                }
+                break;
+            case ')': token.type = Token::Type::kRightParenthesis; ++i; break;
+            case '\\': i = ParseEscape(a_pattern, i, token.symbols); break;
+            case '[': i = ParseClass(a_pattern, i, token.symbols); break;
+            case '.':
+                token.symbols.Add('\n');
+                token.symbols.Negate();
+                ++i;
+                break;
+            default:
+                token.symbols.Add(static_cast<unsigned char>(a_pattern[i]));
+                ++i;
+                break;
+        }
+        tokens.push_back(token);
+    }
+    return tokens;
+}
+
+size_t Regex::ParseEscape(const string& a_pattern, size_t i, ByteSet& symbols) {
+    if(i + 1 >= a_pattern.size()) throw std::invalid_argument("Pattern ends with a '\\'.");
+    
+    char c = a_pattern[i + 1];
+    ByteSet escaped;
+    switch(c) {
+        case 'd': case 'D':
+            escaped.AddRange('0', '9');
+            break;
+        case 'w': case 'W':
+            escaped.AddRange('0', '9');
+            escaped.AddRange('A', 'Z');
+            escaped.AddRange('a', 'z');
+            escaped.Add('_');
+            break;
+        case 's': case 'S':
+            escaped.AddRange('\t', '\r'); //\t \n \v \f \r
+            escaped.Add(' ');
+            break;
+        case 'n': escaped.Add('\n'); break;
+        case 't': escaped.Add('\t'); break;
+        case 'r': escaped.Add('\r'); break;
+        case 'f': escaped.Add('\f'); break;
+        case 'v': escaped.Add('\v'); break;
+        case 'x': {
+                //Exactly two hex digits.
+                int value = 0;
+                for(size_t j = i + 2; j < i + 4; ++j) {
+                    char digit = j < a_pattern.size() ? a_pattern[j] : '\0';
+                    if(digit >= '0' && digit <= '9') value = value * 16 + (digit - '0');
+                    else if(digit >= 'a' && digit <= 'f') value = value * 16 + (digit - 'a' + 10);
+                    else if(digit >= 'A' && digit <= 'F') value = value * 16 + (digit - 'A' + 10);
+                    else throw std::invalid_argument("Expected two hex digits after '\\x'.");
+                }
+                symbols.Add(static_cast<unsigned char>(value));
+                return i + 4;
+            }
+        default:
+            //Anything else stands for itself, which is how operators are
+            //matched literally.
+            escaped.Add(static_cast<unsigned char>(c));
+            break;
+    }
+    
+    //Upper case class escapes match everything the lower case ones don't.
+    if(c == 'D' || c == 'W' || c == 'S') escaped.Negate();
+    symbols.AddSet(escaped);
+    return i + 2;
+}
+
+size_t Regex::ParseRepetition(const string& a_pattern, size_t i, Token& token) {
+    //Parses a decimal bound at "a_pattern[j]", advancing "j" past it.
+    //Returns false if there is no digit there.
+    auto parse_bound = [&a_pattern](size_t& j, std::uint32_t& bound) {
+        if(j >= a_pattern.size() || !std::isdigit(static_cast<unsigned char>(a_pattern[j]))) return false;
+        std::uint64_t value = 0;
+        while(j < a_pattern.size() && std::isdigit(static_cast<unsigned char>(a_pattern[j]))) {
+            value = std::min<std::uint64_t>(value * 10 + (a_pattern[j] - '0'), kMaxRepetition + 1);
+            ++j;
+        }
+        bound = static_cast<std::uint32_t>(value);
+        return true;
+    };
+    
+    //Accepts {m}, {m,} and {m,n}. Anything else leaves the '{' a literal.
+    size_t j = i + 1;
+    std::uint32_t min = 0;
+    std::uint32_t max = 0;
+    if(!parse_bound(j, min)) return i;
+    if(j < a_pattern.size() && a_pattern[j] == ',') {
+        ++j;
+        if(!parse_bound(j, max)) max = TNFA::kUnbounded;
+    } else {
+        max = min;
+    }
+    if(j >= a_pattern.size() || a_pattern[j] != '}') return i;
+    
+    if(min > kMaxRepetition || (max != TNFA::kUnbounded && max > kMaxRepetition))
+        throw std::invalid_argument("Repetition count is larger than 1000.");
+    if(max < min) throw std::invalid_argument("Repetition has its bounds out of order.");
+    token.type = Token::Type::kRepetition;
+    token.min = min;
+    token.max = max;
+    return j + 1;
+}
+
+size_t Regex::ParseClass(const string& a_pattern, size_t i, ByteSet& symbols) {
+    ++i; //Skip '['.
+    bool negated = i < a_pattern.size() && a_pattern[i] == '^';
+    if(negated) ++i;
+    
+    //A ']' right at the start is a literal, not the end of the class.
+    bool first = true;
+    while(i < a_pattern.size() && (a_pattern[i] != ']' || first)) {
+        first = false;
+        
+        //Parse a single item, either a byte or an escape.
+        ByteSet item;
+        bool is_byte = true;
+        unsigned char low = static_cast<unsigned char>(a_pattern[i]);
+        if(a_pattern[i] == '\\') {
+            i = ParseEscape(a_pattern, i, item);
+            is_byte = item.GetCount() == 1;
+            if(is_byte) low = item.GetRanges()[0].first;
+        } else {
+            item.Add(low);
+            ++i;
+        }
+        
+        //A '-' between two bytes makes a range, anywhere else it is a
+        //literal.
+        if(is_byte && i + 1 < a_pattern.size() && a_pattern[i] == '-' && a_pattern[i + 1] != ']') {
+            ByteSet upper;
+            unsigned char high = static_cast<unsigned char>(a_pattern[i + 1]);
+            if(a_pattern[i + 1] == '\\') {
+                i = ParseEscape(a_pattern, i + 1, upper);
+                if(upper.GetCount() != 1) throw std::invalid_argument("Invalid range in character class.");
+                high = upper.GetRanges()[0].first;
+            } else {
+                i += 2;
+            }
+            if(high < low) throw std::invalid_argument("Invalid range in character class.");
+            item.AddRange(low, high);
+        }
+        
+        symbols.AddSet(item);
+    }
+    
+    if(i >= a_pattern.size()) throw std::invalid_argument("Missing ']' in character class.");
+    if(negated) symbols.Negate();
+    return i + 1; //Skip ']'.
+}
+
 //TODO: make this less ugly.
-string Regex::MakeConcatenationExplicit(const string& a_pattern) const {
-    std::string result = "";
-    for(int i{}; i < a_pattern.size(); ++i) {
-        if (i > 0 && 
-            !(a_pattern[i - 1] == '|' || a_pattern[i - 1] == '(' || a_pattern[i - 1] == '+') &&
-            !(a_pattern[i] == '|' || a_pattern[i] == '*' || a_pattern[i] == ')' || a_pattern[i] == '+')) {
-            result += '+';
+vector<Regex::Token> Regex::MakeConcatenationExplicit(const vector<Token>& tokens) {
+    vector<Token> result;
+    result.reserve(2 * tokens.size());
+    for(size_t i = 0; i < tokens.size(); ++i) {
+        if(i > 0) {
+            Token::Type previous = tokens[i - 1].type;
+            Token::Type current = tokens[i].type;
+            if(!(previous == Token::Type::kAlternation || previous == Token::Type::kLeftParenthesis ||
+                 previous == Token::Type::kConcatenation) &&
+               !(current == Token::Type::kAlternation || current == Token::Type::kKleeneClosure ||
+                 current == Token::Type::kOneOrMore || current == Token::Type::kZeroOrOne ||
+                 current == Token::Type::kRepetition || current == Token::Type::kRightParenthesis ||
+                 current == Token::Type::kConcatenation)) {
+                Token concatenation;
+                concatenation.type = Token::Type::kConcatenation;
+                result.push_back(concatenation);
+            }
         }
-        result += a_pattern[i];
+        result.push_back(tokens[i]);
     }
     return result;
 }
 
-string Regex::RegexToPostFix(const string& a_pattern) const {
+vector<Regex::Token> Regex::RegexToPostFix(const string& a_pattern) {
     //Setup for shunting yard algorithm.
-    unordered_map<char, int> precedence = {{'*', 3}, {'+', 2}, {'|', 1}};
-    stack<char> operators;
-    string output;
+    auto precedence = [](Token::Type type) {
+        switch(type) {
+            case Token::Type::kKleeneClosure:
+            case Token::Type::kOneOrMore:
+            case Token::Type::kZeroOrOne:
+            case Token::Type::kRepetition:
+                return 3;
+            case Token::Type::kConcatenation: return 2;
+            case Token::Type::kAlternation: return 1;
+            default: return 0;
+        }
+    };
+    vector<Token> tokens = MakeConcatenationExplicit(Tokenize(a_pattern));
+    stack<Token, vector<Token>> operators;
+    vector<Token> output;
+    output.reserve(tokens.size());
     
     //Do shunting yard algorithm.
-    for(const char& c : MakeConcatenationExplicit(a_pattern)) {
-        if(c == '*' || c == '+' || c == '|') {
-            while(!operators.empty() && precedence[c] <= precedence[operators.top()]) {
-                output += operators.top();
-                operators.pop();
-            }
-            operators.push(c);
-        } else if(c == '(') {
-            operators.push(c);
-        } else if(c == ')') {
-            while(!operators.empty() && operators.top() != '(') {
-                output += operators.top();
-                operators.pop();
-            }
-            operators.pop();
-        } else {
-            output += c;
+    Token::Type previous = Token::Type::kConcatenation;
+    for(const Token& token : tokens) {
+        switch(token.type) {
+            case Token::Type::kKleeneClosure:
+            case Token::Type::kOneOrMore:
+            case Token::Type::kZeroOrOne:
+            case Token::Type::kRepetition:
+            case Token::Type::kConcatenation:
+            case Token::Type::kAlternation:
+                while(!operators.empty() && precedence(token.type) <= precedence(operators.top().type)) {
+                    output.push_back(operators.top());
+                    operators.pop();
+                }
+                operators.push(token);
+                break;
+            case Token::Type::kLeftParenthesis:
+                operators.push(token);
+                break;
+            case Token::Type::kRightParenthesis: {
+                    while(!operators.empty() && operators.top().type != Token::Type::kLeftParenthesis) {
+                        output.push_back(operators.top());
+                        operators.pop();
+                    }
+                    if(operators.empty()) throw std::invalid_argument("Unbalanced ')' in pattern.");
+                    
+                    //A capturing group wraps whatever it enclosed, which
+                    //may be nothing at all.
+                    if(previous == Token::Type::kLeftParenthesis) {
+                        Token empty;
+                        empty.type = Token::Type::kEmpty;
+                        output.push_back(empty);
+                    }
+                    if(operators.top().group != 0) {
+                        Token capture;
+                        capture.type = Token::Type::kCapture;
+                        capture.group = operators.top().group;
+                        output.push_back(capture);
+                    }
+                    operators.pop();
+                }
+                break;
+            default:
+                output.push_back(token);
+                break;
         }
+        previous = token.type;
     }
     while(!operators.empty()) {
-        output += operators.top();
+        if(operators.top().type == Token::Type::kLeftParenthesis)
+            throw std::invalid_argument("Unbalanced '(' in pattern.");
+        output.push_back(operators.top());
         operators.pop();
     }
     return output;
 }
 
-void Regex::DoThompsonsConstruction(const string& a_pattern) {
-    stack<TNFA> nfa_stack;
-    for(const char& c : RegexToPostFix(a_pattern)) {
-        switch(c) {
-            case '*': {
-                    auto x = nfa_stack.top();
-                    nfa_stack.pop();
-                    nfa_stack.push(x.ApplyKleeneClosure());
+TNFA Regex::DoThompsonsConstruction(const vector<Token>& postfix, std::uint32_t& group_count) {
+    //Sets of literals only become tries when the pattern has no groups,
+    //since the trie tries its literals in a different order than the
+    //pattern lists them, which would change the groups the Pike VM picks.
+    bool literal_sets = std::none_of(postfix.begin(), postfix.end(), [](const Token& token) {
+        return token.type == Token::Type::kCapture;
+    });
+    
+    //Operands are moved off the stack and combined in place, so no state
+    //is ever copied more than a logarithmic number of times.
+    vector<Operand> operands;
+    group_count = 0;
+    for(size_t i = 0; i < postfix.size(); ++i) {
+        const Token& token = postfix[i];
+        
+        //A byte that extends a single literal, as in "abc", is appended to
+        //it in place.
+        if(literal_sets && IsAppendedByte(postfix, i) && !operands.empty() &&
+           operands.back().kind == Operand::Kind::kLiterals && operands.back().literals.size() == 1) {
+            operands.back().literals[0] += static_cast<char>(token.symbols.GetMin());
+            ++i;
+            continue;
+        }
+        
+        //Every operator needs its operands on the stack.
+        size_t needed = 2;
+        switch(token.type) {
+            case Token::Type::kSymbol:
+            case Token::Type::kEmpty:
+                needed = 0;
+                break;
+            case Token::Type::kKleeneClosure:
+            case Token::Type::kOneOrMore:
+            case Token::Type::kZeroOrOne:
+            case Token::Type::kRepetition:
+            case Token::Type::kCapture:
+                needed = 1;
+                break;
+            default:
+                break;
+        }
+        if(operands.size() < needed) throw std::invalid_argument("Operator is missing an operand.");
+        
+        switch(token.type) {
+            case Token::Type::kKleeneClosure:
+                BuildOperand(operands.back()).ApplyKleeneClosure();
+                break;
+            case Token::Type::kOneOrMore:
+                BuildOperand(operands.back()).ApplyOneOrMore();
+                break;
+            case Token::Type::kZeroOrOne:
+                BuildOperand(operands.back()).ApplyOptional();
+                break;
+            case Token::Type::kRepetition: {
+                    //Every copy is built, so bound how many states they add
+                    //up to.
+                    TNFA& nfa = BuildOperand(operands.back());
+                    size_t copies = token.max == TNFA::kUnbounded ? token.min + 1 : token.max;
+                    if(copies * nfa.GetStateCount() > kMaxRepetitionStates)
+                        throw std::invalid_argument("Repetition expands to too many states.");
+                    nfa.ApplyRepetition(token.min, token.max);
                 }
                 break;
-            case '+': {
-                    auto rhs = nfa_stack.top();
-                    nfa_stack.pop();
-                    auto lhs = nfa_stack.top();
-                    nfa_stack.pop();
-                    nfa_stack.push(lhs + rhs);
+            case Token::Type::kCapture:
+                BuildOperand(operands.back()).ApplyCapture(token.group);
+                group_count = std::max(group_count, token.group);
+                break;
+            case Token::Type::kEmpty:
+                operands.emplace_back();
+                if(literal_sets) {
+                    operands.back().kind = Operand::Kind::kLiterals;
+                    operands.back().literals.emplace_back();
+                } else {
+                    operands.back().nfa = MakeEmptyStringNFA();
                 }
                 break;
-            case '|': {
-                    auto rhs = nfa_stack.top();
-                    nfa_stack.pop();
-                    auto lhs = nfa_stack.top();
-                    nfa_stack.pop();
-                    nfa_stack.push(lhs | rhs);
+            case Token::Type::kConcatenation: {
+                    Operand rhs = std::move(operands.back());
+                    operands.pop_back();
+                    Operand& lhs = operands.back();
+                    if(lhs.kind == Operand::Kind::kLiterals && rhs.kind == Operand::Kind::kLiterals &&
+                       ConcatenateLiterals(lhs.literals, rhs.literals))
+                        break;
+                    BuildOperand(lhs) += std::move(BuildOperand(rhs));
+                }
+                break;
+            case Token::Type::kAlternation: {
+                    Operand rhs = std::move(operands.back());
+                    operands.pop_back();
+                    Operand& lhs = operands.back();
+                    //The order of a set of literals doesn't matter, so the
+                    //smaller one is moved into the larger one. Otherwise
+                    //"a|(?:b|(?:c|...))" would move every literal once per
+                    //level it is nested.
+                    if(lhs.kind == Operand::Kind::kLiterals && rhs.kind == Operand::Kind::kLiterals) {
+                        if(rhs.literals.size() > lhs.literals.size()) lhs.literals.swap(rhs.literals);
+                        for(string& literal : rhs.literals) lhs.literals.push_back(std::move(literal));
+                        break;
+                    }
+                    
+                    //Branches keep their order, so the smaller list is put
+                    //in front of or behind the larger one.
+                    if(lhs.kind != Operand::Kind::kAlternation) {
+                        TNFA branch = std::move(BuildOperand(lhs));
+                        lhs.kind = Operand::Kind::kAlternation;
+                        lhs.alternatives.push_back(std::move(branch));
+                    }
+                    if(rhs.kind == Operand::Kind::kAlternation) {
+                        if(rhs.alternatives.size() > lhs.alternatives.size()) {
+                            for(auto it = lhs.alternatives.rbegin(); it != lhs.alternatives.rend(); ++it)
+                                rhs.alternatives.push_front(std::move(*it));
+                            lhs.alternatives.swap(rhs.alternatives);
+                        } else {
+                            for(TNFA& branch : rhs.alternatives) lhs.alternatives.push_back(std::move(branch));
+                        }
+                    } else {
+                        lhs.alternatives.push_back(std::move(BuildOperand(rhs)));
+                    }
                 }
                 break;
             default:
-                nfa_stack.push(TNFA(c));
+                operands.emplace_back();
+                if(literal_sets && token.symbols.GetCount() == 1) {
+                    operands.back().kind = Operand::Kind::kLiterals;
+                    operands.back().literals.emplace_back(1, static_cast<char>(token.symbols.GetMin()));
+                } else {
+                    operands.back().nfa = TNFA(token.symbols);
+                }
                 break;
         }
     }
-    this->nfa = nfa_stack.top();
-    return;
+    
+    //An empty pattern only matches the empty string.
+    if(operands.empty()) return MakeEmptyStringNFA();
+    if(operands.size() > 1) throw std::invalid_argument("Operand is missing an operator.");
+    return std::move(BuildOperand(operands.back()));
+}
+
+bool Regex::Node::operator==(const Node& a_node) const {
+    if(this->token.type != a_node.token.type || this->children.size() != a_node.children.size()) return false;
+    if(this->token.type == Token::Type::kSymbol && !(this->token.symbols == a_node.token.symbols)) return false;
+    if(this->token.type == Token::Type::kRepetition &&
+       (this->token.min != a_node.token.min || this->token.max != a_node.token.max))
+        return false;
+    for(size_t i = 0; i < this->children.size(); ++i) {
+        if(!(this->children[i] == a_node.children[i])) return false;
+    }
+    return true;
 }
 
-void Regex::GetEpsilonClosure(State* current, unordered_set<State*>& visited) const {
-    //Mark current state as visited.
-    visited.insert(current);
+vector<Regex::Token> Regex::SimplifyPostFix(const vector<Token>& postfix) {
+    //Concatenations and alternations of single bytes are sets of literals,
+    //which nothing is done to, so large word lists skip building a tree.
+    bool literals = std::all_of(postfix.begin(), postfix.end(), [](const Token& token) {
+        return token.type == Token::Type::kConcatenation || token.type == Token::Type::kAlternation ||
+               token.type == Token::Type::kCapture ||
+               (token.type == Token::Type::kSymbol && token.symbols.GetCount() == 1);
+    });
+    vector<Token> simplified;
+    simplified.reserve(postfix.size());
+    Node root;
+    if(literals || !BuildTree(postfix, root)) {
+        for(const Token& token : postfix) {
+            if(token.type != Token::Type::kCapture) simplified.push_back(token);
+        }
+        return simplified;
+    }
+    Simplify(root);
+    WritePostFix(root, simplified);
+    return simplified;
+}
+
+bool Regex::BuildTree(const vector<Token>& postfix, Node& root) {
+    vector<Node> nodes;
+    vector<size_t> depths; //Depth of the tree of each entry of "nodes".
+    for(const Token& token : postfix) {
+        size_t needed = 0;
+        switch(token.type) {
+            case Token::Type::kConcatenation:
+            case Token::Type::kAlternation:
+                needed = 2;
+                break;
+            case Token::Type::kKleeneClosure:
+            case Token::Type::kOneOrMore:
+            case Token::Type::kZeroOrOne:
+            case Token::Type::kRepetition:
+            case Token::Type::kCapture:
+                needed = 1;
+                break;
+            default:
+                break;
+        }
+        if(nodes.size() < needed) return false;
+        
+        switch(token.type) {
+            case Token::Type::kCapture:
+                break;
+            case Token::Type::kConcatenation:
+            case Token::Type::kAlternation: {
+                    //"abc" is "(ab)c", so runs of the same operator grow the
+                    //node on the left.
+                    Node rhs = std::move(nodes.back());
+                    nodes.pop_back();
+                    size_t rhs_depth = depths.back();
+                    depths.pop_back();
+                    if(nodes.back().token.type != token.type) {
+                        Node node;
+                        node.token = token;
+                        node.children.push_back(std::move(nodes.back()));
+                        nodes.back() = std::move(node);
+                        ++depths.back();
+                    }
+                    nodes.back().children.push_back(std::move(rhs));
+                    depths.back() = std::max(depths.back(), rhs_depth + 1);
+                }
+                break;
+            case Token::Type::kKleeneClosure:
+            case Token::Type::kOneOrMore:
+            case Token::Type::kZeroOrOne:
+            case Token::Type::kRepetition: {
+                    Node node;
+                    node.token = token;
+                    node.children.push_back(std::move(nodes.back()));
+                    nodes.back() = std::move(node);
+                    ++depths.back();
+                }
+                break;
+            default:
+                nodes.emplace_back();
+                nodes.back().token = token;
+                depths.push_back(1);
+                break;
+        }
+        if(!depths.empty() && depths.back() > kMaxSimplifyDepth) return false;
+    }
+    if(nodes.size() != 1) return false;
+    root = std::move(nodes.back());
+    return true;
+}
+
+void Regex::Simplify(Node& node) {
+    for(Node& child : node.children) Simplify(child);
     
-    //Visit all other neighboring states of the current state via 
-    //epsilon transitions.
-    for(State* next_state : current->epsilon_transitions)
-        if(visited.count(next_state) == 0)
-            GetEpsilonClosure(next_state, visited);
-            
+    auto make_empty = [&node](void) {
+        node.children.clear();
+        node.token = Token();
+        node.token.type = Token::Type::kEmpty;
+    };
+    auto replace_with_child = [&node](size_t i) {
+        Node child = std::move(node.children[i]);
+        node = std::move(child);
+    };
+    auto is_repeat = [](const Node& a_node) {
+        return a_node.token.type == Token::Type::kKleeneClosure || a_node.token.type == Token::Type::kOneOrMore ||
+               a_node.token.type == Token::Type::kZeroOrOne;
+    };
+    
+    switch(node.token.type) {
+        case Token::Type::kRepetition: {
+                std::uint32_t min = node.token.min;
+                std::uint32_t max = node.token.max;
+                if(max == 0 || node.children[0].token.type == Token::Type::kEmpty) {
+                    make_empty();
+                    return;
+                }
+                if(min == 1 && max == 1) {
+                    replace_with_child(0);
+                    return;
+                }
+                if(max == TNFA::kUnbounded && min <= 1) {
+                    node.token.type = min == 0 ? Token::Type::kKleeneClosure : Token::Type::kOneOrMore;
+                } else if(min == 0 && max == 1) {
+                    node.token.type = Token::Type::kZeroOrOne;
+                } else {
+                    //Any number of copies of a* is a*.
+                    if(node.children[0].token.type == Token::Type::kKleeneClosure) replace_with_child(0);
+                    return;
+                }
+            }
+            [[fallthrough]];
+        case Token::Type::kKleeneClosure:
+        case Token::Type::kOneOrMore:
+        case Token::Type::kZeroOrOne: {
+                Node& child = node.children[0];
+                if(child.token.type == Token::Type::kEmpty) {
+                    make_empty();
+                    return;
+                }
+                
+                //Two of the same collapse into one, and any other two can
+                //match nothing or repeat, which is a*.
+                if(is_repeat(child)) {
+                    if(child.token.type != node.token.type) node.token.type = Token::Type::kKleeneClosure;
+                    Node grandchild = std::move(child.children[0]);
+                    node.children[0] = std::move(grandchild);
+                }
+            }
+            return;
+        case Token::Type::kConcatenation: {
+                //Empty parts match nothing, and a*a* is a*.
+                vector<Node> parts;
+                parts.reserve(node.children.size());
+                auto append = [&parts](Node& part) {
+                    if(part.token.type == Token::Type::kEmpty) return;
+                    if(!parts.empty() && part.token.type == Token::Type::kKleeneClosure && parts.back() == part) return;
+                    parts.push_back(std::move(part));
+                };
+                for(Node& child : node.children) {
+                    if(child.token.type != Token::Type::kConcatenation) append(child);
+                    else for(Node& part : child.children) append(part);
+                }
+                node.children = std::move(parts);
+                if(node.children.empty()) make_empty();
+                else if(node.children.size() == 1) replace_with_child(0);
+            }
+            return;
+        case Token::Type::kAlternation: {
+                vector<Node> alternatives;
+                alternatives.reserve(node.children.size());
+                for(Node& child : node.children) {
+                    if(child.token.type != Token::Type::kAlternation) alternatives.push_back(std::move(child));
+                    else for(Node& alternative : child.children) alternatives.push_back(std::move(alternative));
+                }
+                node.children = std::move(alternatives);
+                
+                //Alternations of plain literals become tries or Aho-Corasick
+                //automata later on, which share their prefixes already.
+                auto is_byte = [](const Node& a_node) {
+                    return a_node.token.type == Token::Type::kSymbol && a_node.token.symbols.GetCount() == 1;
+                };
+                bool literals = std::all_of(node.children.begin(), node.children.end(), [&is_byte](const Node& a_node) {
+                    return is_byte(a_node) || (a_node.token.type == Token::Type::kConcatenation &&
+                                               std::all_of(a_node.children.begin(), a_node.children.end(), is_byte));
+                });
+                if(literals) return;
+                
+                //Classes merge into the first one, empty alternatives are
+                //taken out and later ones that repeat an earlier one too.
+                vector<Node>& children = node.children;
+                bool has_empty = false;
+                size_t first_class = children.size();
+                size_t kept = 0;
+                for(size_t i = 0; i < children.size(); ++i) {
+                    if(children[i].token.type == Token::Type::kEmpty) {
+                        has_empty = true;
+                        continue;
+                    }
+                    if(children[i].token.type == Token::Type::kSymbol) {
+                        if(first_class < kept) {
+                            children[first_class].token.symbols.AddSet(children[i].token.symbols);
+                            continue;
+                        }
+                        first_class = kept;
+                    }
+                    if(children.size() <= kMaxFactoredAlternatives &&
+                       std::find(children.begin(), children.begin() + kept, children[i]) != children.begin() + kept)
+                        continue;
+                    if(kept != i) children[kept] = std::move(children[i]);
+                    ++kept;
+                }
+                children.resize(kept);
+                
+                if(children.size() > 1 && children.size() <= kMaxFactoredAlternatives) FactorAlternatives(node, false);
+                if(node.token.type == Token::Type::kAlternation && node.children.size() > 1 &&
+                   node.children.size() <= kMaxFactoredAlternatives)
+                    FactorAlternatives(node, true);
+                
+                if(node.token.type == Token::Type::kAlternation && node.children.size() == 1) replace_with_child(0);
+                else if(node.token.type == Token::Type::kAlternation && node.children.empty()) make_empty();
+                if(has_empty && node.token.type != Token::Type::kEmpty) {
+                    Node optional;
+                    optional.token.type = Token::Type::kZeroOrOne;
+                    optional.children.push_back(std::move(node));
+                    node = std::move(optional);
+                    Simplify(node);
+                }
+            }
+            return;
+        default:
+            return;
+    }
+}
+
+void Regex::FactorAlternatives(Node& node, bool suffix) {
+    //The parts of an alternative, which is a concatenation or a single
+    //part, counted from the start, or from the end if "suffix" is set.
+    auto count = [](const Node& a_node) {
+        return a_node.token.type == Token::Type::kConcatenation ? a_node.children.size() : 1;
+    };
+    auto part = [suffix](const Node& a_node, size_t k) -> const Node& {
+        if(a_node.token.type != Token::Type::kConcatenation) return a_node;
+        return suffix ? a_node.children[a_node.children.size() - 1 - k] : a_node.children[k];
+    };
+    
+    vector<Node>& alternatives = node.children;
+    vector<Node> factored;
+    vector<bool> done(alternatives.size(), false);
+    for(size_t i = 0; i < alternatives.size(); ++i) {
+        if(done[i]) continue;
+        vector<size_t> group{i};
+        for(size_t j = i + 1; j < alternatives.size(); ++j) {
+            if(!done[j] && part(alternatives[j], 0) == part(alternatives[i], 0)) group.push_back(j);
+        }
+        if(group.size() == 1) {
+            factored.push_back(std::move(alternatives[i]));
+            continue;
+        }
+        
+        //Take out as many parts as all of the group shares.
+        size_t shared = 1;
+        size_t fewest = count(alternatives[i]);
+        for(size_t j : group) fewest = std::min(fewest, count(alternatives[j]));
+        while(shared < fewest && std::all_of(group.begin(), group.end(), [&](size_t j) {
+            return part(alternatives[j], shared) == part(alternatives[i], shared);
+        }))
+            ++shared;
+        
+        Node rest;
+        rest.token.type = Token::Type::kAlternation;
+        for(size_t j : group) {
+            done[j] = true;
+            vector<Node> parts;
+            Node& alternative = alternatives[j];
+            if(alternative.token.type == Token::Type::kConcatenation) {
+                size_t first = suffix ? 0 : shared;
+                size_t last = suffix ? alternative.children.size() - shared : alternative.children.size();
+                for(size_t k = first; k < last; ++k) parts.push_back(std::move(alternative.children[k]));
+            }
+            Node tail;
+            tail.token.type = Token::Type::kConcatenation;
+            tail.children = std::move(parts);
+            rest.children.push_back(std::move(tail));
+        }
+        
+        //The shared parts are taken from the first alternative of the group.
+        Node& first = alternatives[i];
+        Node combined;
+        combined.token.type = Token::Type::kConcatenation;
+        if(suffix) combined.children.push_back(std::move(rest));
+        if(first.token.type != Token::Type::kConcatenation) {
+            combined.children.push_back(std::move(first));
+        } else {
+            size_t begin = suffix ? first.children.size() - shared : 0;
+            for(size_t k = begin; k < begin + shared; ++k) combined.children.push_back(std::move(first.children[k]));
+        }
+        if(!suffix) combined.children.push_back(std::move(rest));
+        Simplify(combined);
+        factored.push_back(std::move(combined));
+    }
+    
+    if(factored.size() == 1) {
+        Node only = std::move(factored[0]);
+        node = std::move(only);
+    } else {
+        alternatives = std::move(factored);
+    }
     return;
 }
 
+void Regex::WritePostFix(const Node& node, vector<Token>& postfix) {
+    switch(node.token.type) {
+        case Token::Type::kConcatenation:
+        case Token::Type::kAlternation:
+            WritePostFix(node.children[0], postfix);
+            for(size_t i = 1; i < node.children.size(); ++i) {
+                WritePostFix(node.children[i], postfix);
+                postfix.push_back(node.token);
+            }
+            return;
+        case Token::Type::kKleeneClosure:
+        case Token::Type::kOneOrMore:
+        case Token::Type::kZeroOrOne:
+        case Token::Type::kRepetition:
+            WritePostFix(node.children[0], postfix);
+            postfix.push_back(node.token);
+            return;
+        default:
+            postfix.push_back(node.token);
+            return;
+    }
+}
+
+TNFA& Regex::BuildOperand(Operand& operand) {
+    switch(operand.kind) {
+        case Operand::Kind::kLiterals:
+            operand.nfa = TNFA(operand.literals);
+            operand.literals = vector<string>();
+            break;
+        case Operand::Kind::kAlternation:
+            operand.nfa = BuildAlternation(operand.alternatives, 0, operand.alternatives.size());
+            operand.alternatives = deque<TNFA>();
+            break;
+        default:
+            break;
+    }
+    operand.kind = Operand::Kind::kNFA;
+    return operand.nfa;
+}
+
+TNFA Regex::BuildAlternation(deque<TNFA>& alternatives, size_t begin, size_t end) {
+    if(end - begin == 1) return std::move(alternatives[begin]);
+    size_t middle = begin + (end - begin) / 2;
+    TNFA nfa = BuildAlternation(alternatives, begin, middle);
+    nfa |= BuildAlternation(alternatives, middle, end);
+    return nfa;
+}
+
+bool Regex::IsAppendedByte(const vector<Token>& postfix, size_t i) {
+    return postfix[i].type == Token::Type::kSymbol && postfix[i].symbols.GetCount() == 1 &&
+           i + 1 < postfix.size() && postfix[i + 1].type == Token::Type::kConcatenation;
+}
+
+bool Regex::ConcatenateLiterals(vector<string>& lhs, const vector<string>& rhs) {
+    size_t lhs_bytes = 0;
+    size_t rhs_bytes = 0;
+    for(const string& literal : lhs) lhs_bytes += literal.size();
+    for(const string& literal : rhs) rhs_bytes += literal.size();
+    if(lhs_bytes * rhs.size() + rhs_bytes * lhs.size() > kMaxLiteralBytes) return false;
+    
+    //Appending a single literal is the common case, as in "abc".
+    if(rhs.size() == 1) {
+        for(string& literal : lhs) literal += rhs[0];
+        return true;
+    }
+    vector<string> product;
+    product.reserve(lhs.size() * rhs.size());
+    for(const string& prefix : lhs)
+        for(const string& suffix : rhs) product.push_back(prefix + suffix);
+    lhs.swap(product);
+    return true;
+}
+
+bool Regex::ExtractLiterals(const vector<Token>& postfix, vector<string>& literals) {
+    vector<vector<string>> sets;
+    for(size_t i = 0; i < postfix.size(); ++i) {
+        const Token& token = postfix[i];
+        if(IsAppendedByte(postfix, i) && !sets.empty() && sets.back().size() == 1) {
+            sets.back()[0] += static_cast<char>(token.symbols.GetMin());
+            ++i;
+            continue;
+        }
+        
+        switch(token.type) {
+            case Token::Type::kSymbol:
+                if(token.symbols.GetCount() != 1) return false;
+                sets.emplace_back(1, string(1, static_cast<char>(token.symbols.GetMin())));
+                break;
+            case Token::Type::kCapture:
+                if(sets.empty()) return false;
+                break;
+            case Token::Type::kConcatenation:
+            case Token::Type::kAlternation: {
+                    if(sets.size() < 2) return false;
+                    vector<string> rhs = std::move(sets.back());
+                    sets.pop_back();
+                    if(token.type == Token::Type::kAlternation) {
+                        if(rhs.size() > sets.back().size()) sets.back().swap(rhs);
+                        for(string& literal : rhs) sets.back().push_back(std::move(literal));
+                    } else if(!ConcatenateLiterals(sets.back(), rhs)) {
+                        return false;
+                    }
+                }
+                break;
+            default:
+                return false;
+        }
+    }
+    if(sets.size() != 1) return false;
+    
+    for(const string& literal : sets.back()) if(literal.empty()) return false;
+    literals.swap(sets.back());
+    return true;
+}
+
+Prefilter Regex::ExtractRequiredLiteral(const vector<Token>& postfix) {
+    const size_t kUnbounded = Prefilter::kUnbounded;
+    auto add = [kUnbounded](size_t a, size_t b) {
+        return a == kUnbounded || b == kUnbounded ? kUnbounded : a + b;
+    };
+    auto multiply = [kUnbounded](size_t a, size_t b) {
+        if(a == 0 || b == 0) return size_t(0);
+        return a == kUnbounded || b == kUnbounded || a > kUnbounded / b ? kUnbounded : a * b;
+    };
+    
+    //Keeps the longer of the current and a new required literal, or the
+    //one that can start less far into a match if they are equally long.
+    auto keep = [](LiteralInfo& info, const string& literal, size_t offset) {
+        if(literal.size() > info.inner.size() ||
+           (literal.size() == info.inner.size() && offset < info.inner_offset)) {
+            info.inner = literal.substr(0, Prefilter::kMaxLength);
+            info.inner_offset = offset;
+        }
+    };
+    
+    //Exact strings stop being exact once they are too long to track, and
+    //the affixes keep the bytes next to the start and end of the match.
+    auto shorten = [](LiteralInfo& info) {
+        if(info.prefix.size() > Prefilter::kMaxLength) {
+            info.exact = false;
+            info.prefix.resize(Prefilter::kMaxLength);
+        }
+        if(info.suffix.size() > Prefilter::kMaxLength)
+            info.suffix.erase(0, info.suffix.size() - Prefilter::kMaxLength);
+    };
+    
+    vector<LiteralInfo> infos;
+    for(const Token& token : postfix) {
+        size_t needed = 0;
+        switch(token.type) {
+            case Token::Type::kConcatenation:
+            case Token::Type::kAlternation:
+                needed = 2;
+                break;
+            case Token::Type::kKleeneClosure:
+            case Token::Type::kOneOrMore:
+            case Token::Type::kZeroOrOne:
+            case Token::Type::kRepetition:
+            case Token::Type::kCapture:
+                needed = 1;
+                break;
+            default:
+                break;
+        }
+        if(infos.size() < needed) return Prefilter();
+        
+        switch(token.type) {
+            case Token::Type::kSymbol: {
+                    LiteralInfo info;
+                    info.max_length = 1;
+                    if(token.symbols.GetCount() == 1) {
+                        info.exact = true;
+                        info.prefix = string(1, static_cast<char>(token.symbols.GetMin()));
+                        info.suffix = info.inner = info.prefix;
+                    }
+                    infos.push_back(std::move(info));
+                }
+                break;
+            case Token::Type::kEmpty:
+                infos.emplace_back();
+                infos.back().exact = true;
+                break;
+            case Token::Type::kCapture:
+                break;
+            case Token::Type::kKleeneClosure:
+            case Token::Type::kZeroOrOne: {
+                    //May match nothing at all.
+                    size_t max_length = infos.back().max_length;
+                    infos.back() = LiteralInfo();
+                    infos.back().max_length = token.type == Token::Type::kZeroOrOne ? max_length : kUnbounded;
+                }
+                break;
+            case Token::Type::kOneOrMore:
+            case Token::Type::kRepetition: {
+                    //The first copy is required, unless there may be none.
+                    //Its affixes and required literal stay the same.
+                    LiteralInfo& info = infos.back();
+                    if(token.type == Token::Type::kRepetition && token.min == 1 && token.max == 1) break;
+                    size_t copies = token.type == Token::Type::kOneOrMore ? TNFA::kUnbounded : token.max;
+                    size_t max_length = copies == TNFA::kUnbounded ? kUnbounded : multiply(info.max_length, copies);
+                    if(token.type == Token::Type::kRepetition && token.min == 0) info = LiteralInfo();
+                    info.exact = false;
+                    info.max_length = max_length;
+                }
+                break;
+            case Token::Type::kConcatenation: {
+                    LiteralInfo rhs = std::move(infos.back());
+                    infos.pop_back();
+                    LiteralInfo lhs = std::move(infos.back());
+                    LiteralInfo& info = infos.back();
+                    info = LiteralInfo();
+                    info.exact = lhs.exact && rhs.exact;
+                    info.prefix = lhs.exact ? lhs.prefix + rhs.prefix : lhs.prefix;
+                    info.suffix = rhs.exact ? lhs.suffix + rhs.suffix : rhs.suffix;
+                    info.max_length = add(lhs.max_length, rhs.max_length);
+                    shorten(info);
+                    
+                    //The suffix of the left side runs right into the prefix
+                    //of the right side, which can make a longer literal.
+                    size_t joint_offset = lhs.max_length == kUnbounded ? kUnbounded :
+                                          lhs.max_length - lhs.suffix.size();
+                    keep(info, lhs.inner, lhs.inner_offset);
+                    keep(info, rhs.inner, add(lhs.max_length, rhs.inner_offset));
+                    keep(info, lhs.suffix + rhs.prefix, joint_offset);
+                    keep(info, info.prefix, 0);
+                    keep(info, info.suffix, info.max_length == kUnbounded ? kUnbounded :
+                                            info.max_length - info.suffix.size());
+                }
+                break;
+            case Token::Type::kAlternation: {
+                    LiteralInfo rhs = std::move(infos.back());
+                    infos.pop_back();
+                    LiteralInfo lhs = std::move(infos.back());
+                    LiteralInfo& info = infos.back();
+                    info = LiteralInfo();
+                    info.exact = lhs.exact && rhs.exact && lhs.prefix == rhs.prefix;
+                    
+                    //Only what both sides share is required.
+                    size_t length = 0;
+                    while(length < lhs.prefix.size() && length < rhs.prefix.size() &&
+                          lhs.prefix[length] == rhs.prefix[length]) ++length;
+                    info.prefix = lhs.prefix.substr(0, length);
+                    length = 0;
+                    while(length < lhs.suffix.size() && length < rhs.suffix.size() &&
+                          lhs.suffix[lhs.suffix.size() - length - 1] == rhs.suffix[rhs.suffix.size() - length - 1])
+                        ++length;
+                    info.suffix = lhs.suffix.substr(lhs.suffix.size() - length);
+                    info.max_length = std::max(lhs.max_length, rhs.max_length);
+                    
+                    if(lhs.inner == rhs.inner) keep(info, lhs.inner, std::max(lhs.inner_offset, rhs.inner_offset));
+                    keep(info, info.prefix, 0);
+                    keep(info, info.suffix, info.max_length == kUnbounded ? kUnbounded :
+                                            info.max_length - info.suffix.size());
+                }
+                break;
+            default:
+                return Prefilter();
+        }
+    }
+    
+    if(infos.size() != 1 || infos.back().inner.empty()) return Prefilter();
+    return Prefilter(infos.back().inner, infos.back().inner_offset);
+}
+
+Prefilter Regex::ExtractRequiredLiteral(const vector<string>& literals) {
+    if(literals.empty()) return Prefilter();
+    const string& first = literals[0];
+    size_t prefix = first.size();
+    size_t suffix = first.size();
+    size_t max_length = 0;
+    for(const string& literal : literals) {
+        size_t length = 0;
+        while(length < prefix && length < literal.size() && literal[length] == first[length]) ++length;
+        prefix = length;
+        length = 0;
+        while(length < suffix && length < literal.size() &&
+              literal[literal.size() - length - 1] == first[first.size() - length - 1]) ++length;
+        suffix = length;
+        max_length = std::max(max_length, literal.size());
+    }
+    
+    //The prefix is at the start of every match, the suffix at most the
+    //longest literal's length less its own into one.
+    if(prefix == 0 && suffix == 0) return Prefilter();
+    if(prefix >= suffix) return Prefilter(first.substr(0, std::min(prefix, Prefilter::kMaxLength)), 0);
+    size_t length = std::min(suffix, Prefilter::kMaxLength);
+    return Prefilter(first.substr(first.size() - suffix, length), max_length - suffix);
+}
+
+TNFA Regex::MakeEmptyStringNFA(void) {
+    TNFA nfa;
+    StateId only_state = nfa.AddState(true);
+    nfa.SetStartState(only_state);
+    nfa.SetAcceptState(only_state);
+    return nfa;
+}
+
 //END OF REGEX CLASS IMPLEMENTATION
@@ -5,26 +5,62 @@
  * Programmer: Abdurrahman Alyajouri
  * Date: 11/28/2024
  * Purpose: The purpose of this file is to define the Regex class. Currently
- *          only the 3 fundamental regular expression operations are supported:
- *          concatenation, alternation, and kleene closure.
+ *          the 3 fundamental regular expression operations are supported:
+ *          concatenation, alternation, and kleene closure, along with the
+ *          repetitions '+', '?', {m}, {m,} and {m,n}. Parentheses group and
+ *          capture, "(?:...)" only groups. Symbols can be
+ *          literal bytes, escapes (\d \w \s \D \W \S \n \t \r \f \v
+ *          \xHH, or a backslash in front of an operator), the wildcard '.',
+ *          which matches any byte but '\n', or character classes such as
+ *          [a-z_], [^0-9] and [\w.-].
  */
  
+#include "aho_corasick.h"
+#include "bit_parallel_nfa.h"
+#include "byte_class.h"
+#include "epsilon_free_nfa.h"
+#include "lazy_dfa.h"
+#include "match_context.h"
+#include "pike_vm.h"
+#include "prefilter.h"
+#include "regex_stats.h"
 #include "tnfa.h"
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <optional>
 #include <string>
-#include <unordered_set>
+#include <string_view>
+#include <vector>
 
+using std::deque;
+using std::optional;
+using std::shared_ptr;
+using std::size_t;
 using std::string;
-using std::unordered_set;
+using std::string_view;
+using std::vector;
+
+//The span of a match within the searched input, as byte offsets. "end" is
+//one past the last matched byte, so an empty match has begin == end.
+struct RegexMatch {
+    size_t begin;
+    size_t end;
+};
 
 class Regex {
     public:
-        //Ctor and overloaded dtor.
+        //Ctor and overloaded dtor. Throws std::invalid_argument if the
+        //pattern is malformed. Compiled patterns are looked up in, and
+        //added to, the process wide RegexCache, so building a Regex for a
+        //pattern seen before only copies a pointer.
         Regex();
         Regex(const string& a_pattern);
     
         //Will reconstruct the internal nfa representation of a regex
-        //based on the input pattern. Returns a reference to the
-        //invoking Regex object.
+        //based on the input pattern, going through RegexCache like the
+        //ctor. Returns a reference to the invoking Regex object. Throws
+        //std::invalid_argument if the pattern is malformed.
         Regex& operator=(const string& a_pattern);
         
         //Returns the "pattern" data member.
@@ -32,32 +68,309 @@ class Regex {
     
         //Checks if the input string matches the pattern recognized by "nfa".
         //Only looks for exact matches from the beginning of a string to the
-        //end. Returns if it matched or not (true/false);
-        bool Match(const string& input) const;
+        //end. Returns if it matched or not (true/false). Patterns with few
+        //enough symbol positions run on the bit parallel simulation of
+        //their Glushkov automaton. Others run on the lazy DFA, falling back
+        //to simulating the epsilon free NFA if its cache is thrashing. The
+        //first version uses a context kept by the calling thread, so a const
+        //Regex can be matched on many threads at once either way. The
+        //second one uses "context", which makes it allocation free once the
+        //context has warmed up.
+        bool Match(string_view input) const;
+        bool Match(string_view input, MatchContext& context) const;
+        
+        //Searches "input" for the leftmost match that starts at or after
+        //"pos", preferring the longest one among those that start there.
+        //Returns nothing if there is no such match. The first version uses
+        //the calling thread's context, like Match, the second one reuses
+        //"context".
+        optional<RegexMatch> Find(string_view input, size_t pos = 0) const;
+        optional<RegexMatch> Find(string_view input, MatchContext& context, size_t pos = 0) const;
+        
+        //Returns every non-overlapping leftmost-longest match in "input",
+        //in order. An empty match never follows directly behind another
+        //match.
+        vector<RegexMatch> FindAll(string_view input) const;
+        
+        //Returns the number of capture groups, i.e. of '(' not followed by
+        //"?:". Groups are numbered from 1 in the order of their '('.
+        size_t GetGroupCount(void) const;
+        
+        //Returns false if no match of the pattern can contain byte "c", e.g.
+        //'\n' for "[a-z]+:", so that a search of many lines at once can't
+        //find a match that spans two of them.
+        bool CanContainByte(unsigned char c) const;
+        
+        //Like Find and Match, but also reports where each capture group
+        //matched, in a single pass over the input. "groups" receives
+        //GetGroupCount() + 1 entries: entry 0 is the whole match, entry k
+        //the last span group k matched, or nothing if the group took no
+        //part in the match. If the match can be split up in several ways,
+        //earlier alternatives and longer repetitions are preferred. Returns
+        //true if there was a match. The versions without a context use the
+        //calling thread's, like Match.
+        bool FindGroups(string_view input, vector<optional<RegexMatch>>& groups, size_t pos = 0) const;
+        bool FindGroups(string_view input, vector<optional<RegexMatch>>& groups, MatchContext& context,
+                        size_t pos = 0) const;
+        bool MatchGroups(string_view input, vector<optional<RegexMatch>>& groups) const;
+        bool MatchGroups(string_view input, vector<optional<RegexMatch>>& groups, MatchContext& context) const;
+        
+        //Get and set the memory budget, in bytes, of the lazy DFA state
+        //cache the program gets in the thread's context, which the calls
+        //not given one use.
+        size_t GetDFACacheBudget(void) const;
+        void SetDFACacheBudget(size_t a_cache_budget);
+        
+        //Returns a snapshot of the program's size and of what matching did
+        //since the Regex was built, reassigned or ResetStats was called.
+        //Match side counters and the construction time are only kept when
+        //built with REGEX_ENABLE_STATS, and read zero otherwise. Safe to
+        //call while other threads match, since every count is atomic.
+        RegexStats GetStats(void) const;
+        void ResetStats(void);
         
         //TODO: support more regex operations.
         
     private:
-        //Inserts a concatenation symbol '+' into a regular expression where
-        //it is implicitly implied. Returns a copy of the input but with 
-        //explicit concatenation symbols.
-        string MakeConcatenationExplicit(const string& a_pattern) const;
+        //Drives the same search as Find one chunk at a time.
+        friend class StreamMatcher;
+        
+        //Unions the NFAs of many Regex objects.
+        friend class RegexSet;
+        
+        //Determinizes the NFA ahead of time.
+        friend class DFA;
+        
+        //Shares compiled programs between Regex objects.
+        friend class RegexCache;
+        
+        //Everything compiled from a pattern. A program never changes once
+        //built, so any number of Regex objects on any number of threads
+        //can share one.
+        struct Program {
+            TNFA nfa; //The thompson construction based NFA of the simplified pattern.
+            TNFA group_nfa; //NFA of the pattern as written, if it has capture groups.
+            AhoCorasick literals; //If the pattern is an alternation of literals.
+            Prefilter prefilter; //Literal every match contains, if any.
+            ByteClasses byte_classes; //Byte classes of "nfa".
+            BitParallelNFA bit_parallel; //Glushkov automaton of "nfa", if small.
+            EpsilonFreeNFA epsilon_free; //"nfa" without epsilon transitions.
+            PikeVM pike_vm; //Finds the capture groups of "group_nfa", or of "nfa" if there are none.
+            double construction_us = 0; //Time Compile took, with stats on.
+            size_t unsimplified_states = 0; //States of the unsimplified NFA, with stats on.
+            
+            //Returns an estimate of the memory the program uses, in bytes.
+            size_t GetMemoryUsage(void) const;
+        };
+        
+        //Builds the program of a pattern. Throws std::invalid_argument if
+        //the pattern is malformed.
+        static shared_ptr<const Program> Compile(const string& a_pattern);
+        
+        //Checks for a match by simulating "nfa" directly, one set of states
+        //at a time.
+        bool MatchNFA(string_view input, MatchContext& context) const;
+        
+        //Runs the Pike VM in "context" and converts its capture slots to
+        //"groups".
+        bool SearchGroups(string_view input, size_t pos, bool anchored,
+                          vector<optional<RegexMatch>>& groups, MatchContext& context) const;
+        
+        //Same as MatchNFA and Find, but simulating "epsilon_free", which
+        //must be built.
+        bool MatchEpsilonFree(string_view input, MatchContext& context) const;
+        optional<RegexMatch> FindEpsilonFree(string_view input, size_t pos, MatchContext& context) const;
+        
+        //A thread of the unanchored search: an NFA state reached by a match
+        //attempt that began at input offset "start". FindEpsilonFree uses
+        //states of "epsilon_free" instead.
+        using Thread = MatchContext::Thread;
+        
+        //Adds "state" and every state reachable from it via epsilon
+        //transitions to "threads" as threads that began at "start", unless
+        //they are already in the list. A state is in the list if its entry
+        //in "marks" equals "step". "pending" is the stack of the walk.
+        //Returns the number of states the epsilon walk visited.
+        size_t AddThread(vector<Thread>& threads, vector<size_t>& marks, size_t step,
+                         StateId state, size_t start, vector<StateId>& pending) const;
+        
+        //A unit of a pattern: an operator, a parenthesis, or a symbol that
+        //matches a set of bytes. kRepetition stands for {min,max}. In post
+        //fix form, a group's ')' becomes a kCapture operator that wraps the
+        //group, and an empty group becomes a kEmpty operand that only
+        //matches the empty string.
+        struct Token {
+            enum class Type { kSymbol, kConcatenation, kAlternation, kKleeneClosure,
+                              kOneOrMore, kZeroOrOne, kRepetition, kLeftParenthesis,
+                              kRightParenthesis, kCapture, kEmpty };
+            
+            Type type;
+            ByteSet symbols; //The bytes a kSymbol token matches.
+            std::uint32_t group = 0; //Group of a '(' or kCapture, 0 if it doesn't capture.
+            std::uint32_t min = 0; //Bounds of a kRepetition.
+            std::uint32_t max = 0; //TNFA::kUnbounded if there is none.
+        };
+        
+        //Largest bound a counted repetition may have.
+        static constexpr std::uint32_t kMaxRepetition = 1000;
+        
+        //Largest number of states a counted repetition may expand to.
+        static constexpr size_t kMaxRepetitionStates = 1 << 20;
+        
+        //Splits a regular expression into tokens, resolving escapes, '.'
+        //and character classes into the sets of bytes they match.
+        static vector<Token> Tokenize(const string& a_pattern);
+        
+        //Parses the escape sequence whose backslash is at "a_pattern[i]"
+        //and adds the bytes it stands for to "symbols". Returns the index
+        //right after the escape sequence.
+        static size_t ParseEscape(const string& a_pattern, size_t i, ByteSet& symbols);
+        
+        //Parses the character class whose '[' is at "a_pattern[i]" into
+        //"symbols". Returns the index right after its closing ']'.
+        static size_t ParseClass(const string& a_pattern, size_t i, ByteSet& symbols);
+        
+        //Parses the counted repetition whose '{' is at "a_pattern[i]" into
+        //"token". Returns the index right after its closing '}', or "i" if
+        //the '{' doesn't start one and is a literal.
+        static size_t ParseRepetition(const string& a_pattern, size_t i, Token& token);
+        
+        //Inserts a concatenation token into a tokenized regular expression
+        //where it is implicitly implied. Returns a copy of the input but
+        //with explicit concatenation tokens.
+        static vector<Token> MakeConcatenationExplicit(const vector<Token>& tokens);
     
         //Converts a regular expression string into its post fix form for
         //simple stack evaluation. Returns said post fix form.
-        string RegexToPostFix(const string& a_pattern) const;
+        static vector<Token> RegexToPostFix(const string& a_pattern);
         
-        //Constructs an NFA representation of a regex, per the rules 
-        //defined by thompsons construction algorithm. TODO:
-        //Make this a standalone function that returns a TNFA?
-        void DoThompsonsConstruction(const string& a_pattern);
+        //Constructs an NFA representation of a regex in post fix form, per
+        //the rules defined by thompsons construction algorithm, and returns
+        //it. "group_count" receives the number of capture groups.
+        static TNFA DoThompsonsConstruction(const vector<Token>& postfix, std::uint32_t& group_count);
         
-        //Computes the set of all reachable states from the current state
-        //via epsilon transitions.
-        void GetEpsilonClosure(State* current, unordered_set<State*>& visited) const;
-    
-        string pattern; //The regex pattern "nfa" will be built upon.
+        //A node of the syntax tree patterns are simplified on. Concatenations
+        //and alternations have any number of children, the other operators
+        //one, and "token" holds the operator or the bytes of a kSymbol.
+        struct Node {
+            Token token;
+            vector<Node> children;
+            
+            //Checks if two sub-expressions are written the same way.
+            bool operator==(const Node& a_node) const;
+        };
+        
+        //Deepest syntax tree that is simplified. Simplifying recurses, so
+        //deeper ones are left as they are.
+        static constexpr size_t kMaxSimplifyDepth = 1000;
+        
+        //Alternations with more alternatives than this aren't deduplicated
+        //or factored, which compares every pair of them.
+        static constexpr size_t kMaxFactoredAlternatives = 256;
+        
+        //Rewrites the pattern in post fix form "postfix" into one that
+        //matches the same strings with fewer states and epsilon transitions,
+        //and returns it. Its capture groups are left out, since they don't
+        //change what matches. Returns "postfix" without its groups if it is
+        //malformed, so that DoThompsonsConstruction reports the error.
+        static vector<Token> SimplifyPostFix(const vector<Token>& postfix);
+        
+        //Builds the syntax tree of "postfix", leaving out capture groups.
+        //Returns false if it is malformed or nested too deeply.
+        static bool BuildTree(const vector<Token>& postfix, Node& root);
+        
+        //Applies the rewrite rules to "node", its children first:
+        //  - Nested repetitions collapse, e.g. (a*)*, a** and (a+)? are a*.
+        //  - a{0,} is a*, a{1,} is a+, a{0,1} is a? and a{1} is a.
+        //  - Concatenations and alternations absorb nested ones, and empty
+        //    parts of a concatenation are dropped.
+        //  - Alternatives of single bytes or classes merge into one class,
+        //    duplicate alternatives are dropped and an empty alternative
+        //    makes the rest optional.
+        //  - Alternatives that start or end the same way are factored, e.g.
+        //    ab*|ac* becomes a(b*|c*). Alternations of plain literals are
+        //    left alone, since they are built as tries anyway.
+        static void Simplify(Node& node);
+        
+        //Factors the alternatives of alternation "node" that share their
+        //first parts, or their last ones if "suffix" is set.
+        static void FactorAlternatives(Node& node, bool suffix);
+        
+        //Appends the post fix form of "node" to "postfix".
+        static void WritePostFix(const Node& node, vector<Token>& postfix);
+        
+        //An operand on the stack of DoThompsonsConstruction. Building an
+        //operand is put off for as long as it is a set of literals, which
+        //is then built as a trie, or an alternation, which is then built as
+        //a balanced tree so no state is many epsilon transitions deep.
+        struct Operand {
+            enum class Kind { kNFA, kLiterals, kAlternation };
+            
+            Kind kind = Kind::kNFA;
+            TNFA nfa; //The NFA of a kNFA operand.
+            vector<string> literals; //The strings a kLiterals operand matches.
+            deque<TNFA> alternatives; //The branches of a kAlternation, in order.
+        };
+        
+        //Largest number of bytes the literals of an operand may add up to.
+        //Concatenating sets of literals multiplies them out, so bigger
+        //products are built as NFAs instead.
+        static constexpr size_t kMaxLiteralBytes = 1 << 22;
+        
+        //Builds the NFA of an operand, leaving it a kNFA operand.
+        static TNFA& BuildOperand(Operand& operand);
+        
+        //Builds the alternation of "alternatives[begin, end)", balanced.
+        static TNFA BuildAlternation(deque<TNFA>& alternatives, size_t begin, size_t end);
+        
+        //Checks if "postfix[i]" is a single byte that is immediately
+        //concatenated to the operand before it.
+        static bool IsAppendedByte(const vector<Token>& postfix, size_t i);
+        
+        //Replaces "lhs" with every literal of "lhs" followed by every
+        //literal of "rhs". Returns false, leaving "lhs" as it was, if the
+        //result would exceed kMaxLiteralBytes.
+        static bool ConcatenateLiterals(vector<string>& lhs, const vector<string>& rhs);
+        
+        //Checks if the pattern in post fix form "postfix" only matches a
+        //set of non empty literals, ignoring its capture groups, and if so
+        //stores them in "literals".
+        static bool ExtractLiterals(const vector<Token>& postfix, vector<string>& literals);
+        
+        //What a sub-expression says about the literals in its matches, used
+        //to find a literal that every match of the pattern contains.
+        struct LiteralInfo {
+            bool exact = false; //Only ever matches "prefix", which equals "suffix".
+            string prefix; //Every match starts with it.
+            string suffix; //Every match ends with it.
+            string inner; //Every match contains it.
+            size_t inner_offset = 0; //Largest offset "inner" starts at in a match.
+            size_t max_length = 0; //Length of the longest match.
+        };
+        
+        //Finds the longest literal every match of the pattern in post fix
+        //form "postfix" contains. Returns an empty prefilter if there is
+        //none.
+        static Prefilter ExtractRequiredLiteral(const vector<Token>& postfix);
+        
+        //Same for a pattern that only matches "literals", which only have
+        //their longest common prefix or suffix in common.
+        static Prefilter ExtractRequiredLiteral(const vector<string>& literals);
+        
+        //Returns a single state NFA that only matches the empty string.
+        static TNFA MakeEmptyStringNFA(void);
+        
+        string pattern; //The regex pattern "program" was built from.
+        
+        shared_ptr<const Program> program; //The compiled pattern, never null.
+                  
+        size_t cache_budget = LazyDFA::kDefaultCacheBudget; //Of the calls not given a context.
         
-        TNFA nfa; //Will store the thompson construction based NFA 
-                  //representation of the provided regex pattern.
+        //Match side statistics. With stats off the counters are empty, so
+        //they are shared instead of taking room in every Regex.
+#ifdef REGEX_ENABLE_STATS
+        mutable RegexCounters counters;
+#else
+        inline static RegexCounters counters;
+#endif
 };
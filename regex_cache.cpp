@@ -0,0 +1,123 @@
+/*
+ * Filename: regex_cache.cpp
+ * Programmer: Abdurrahman Alyajouri
+ * Date: 10/17/2026
+ * Purpose: The purpose of this file is to implement the RegexCache class
+ *          declared in "regex_cache.h".
+ */
+
+#include "regex_cache.h"
+#include <mutex>
+#include <string>
+
+using std::string;
+
+//BEGINNING OF REGEXCACHE CLASS IMPLEMENTATION
+
+RegexCache::RegexCache(size_t a_memory_budget)
+    : memory_budget(a_memory_budget), memory_used(0), hits(0), misses(0), evictions(0) {}
+
+RegexCache& RegexCache::GetGlobal(void) {
+    static RegexCache global;
+    return global;
+}
+
+size_t RegexCache::GetMemoryBudget(void) const {
+    std::shared_lock<std::shared_mutex> guard(this->lock);
+    return this->memory_budget;
+}
+
+void RegexCache::SetMemoryBudget(size_t a_memory_budget) {
+    std::unique_lock<std::shared_mutex> guard(this->lock);
+    this->memory_budget = a_memory_budget;
+    Evict();
+    return;
+}
+
+void RegexCache::Clear(void) {
+    std::unique_lock<std::shared_mutex> guard(this->lock);
+    this->evictions += this->entries.size();
+    this->entries.clear();
+    this->recency.clear();
+    this->memory_used = 0;
+    return;
+}
+
+std::uint64_t RegexCache::GetHitCount(void) const {
+    return this->hits.load();
+}
+
+std::uint64_t RegexCache::GetMissCount(void) const {
+    return this->misses.load();
+}
+
+std::uint64_t RegexCache::GetEvictionCount(void) const {
+    return this->evictions.load();
+}
+
+size_t RegexCache::GetSize(void) const {
+    std::shared_lock<std::shared_mutex> guard(this->lock);
+    return this->entries.size();
+}
+
+size_t RegexCache::GetMemoryUsed(void) const {
+    std::shared_lock<std::shared_mutex> guard(this->lock);
+    return this->memory_used;
+}
+
+shared_ptr<const Regex::Program> RegexCache::Get(const string& a_pattern) {
+    //Hits only read the map, and take the small lock of the recency list
+    //just long enough to move their entry to its front.
+    {
+        std::shared_lock<std::shared_mutex> guard(this->lock);
+        auto it = this->entries.find(a_pattern);
+        if(it != this->entries.end()) {
+            {
+                std::lock_guard<std::mutex> recency_guard(this->recency_lock);
+                this->recency.splice(this->recency.begin(), this->recency, it->second.position);
+            }
+            ++this->hits;
+            return it->second.program;
+        }
+    }
+
+    //Compile without holding the lock, so a slow pattern doesn't hold up
+    //lookups of other patterns. Two threads missing on the same pattern
+    //may both compile it, the first one to get back keeps its program.
+    ++this->misses;
+    shared_ptr<const Regex::Program> a_program = Regex::Compile(a_pattern);
+    size_t cost = sizeof(Entry) + 2 * a_pattern.size() + a_program->GetMemoryUsage();
+
+    std::unique_lock<std::shared_mutex> guard(this->lock);
+    if(cost > this->memory_budget) return a_program;
+
+    auto inserted = this->entries.try_emplace(a_pattern);
+    Entry& entry = inserted.first->second;
+    if(!inserted.second) {
+        this->recency.splice(this->recency.begin(), this->recency, entry.position);
+        return entry.program;
+    }
+
+    entry.program = a_program;
+    entry.cost = cost;
+    this->recency.push_front(&inserted.first->first);
+    entry.position = this->recency.begin();
+    this->memory_used += cost;
+    Evict();
+    return a_program;
+}
+
+void RegexCache::Evict(void) {
+    //The least recently used entry is at the back of the list. Nothing
+    //else can touch the list under the exclusive lock.
+    while(this->memory_used > this->memory_budget && !this->recency.empty()) {
+        auto oldest = this->entries.find(*this->recency.back());
+        this->recency.pop_back();
+        this->memory_used -= oldest->second.cost;
+        this->entries.erase(oldest);
+        ++this->evictions;
+    }
+    return;
+}
+
+//END OF REGEXCACHE CLASS IMPLEMENTATION
@@ -0,0 +1,94 @@
+#pragma once
+
+/*
+ * Filename: regex_cache.h
+ * Programmer: Abdurrahman Alyajouri
+ * Date: 10/17/2026
+ * Purpose: The purpose of this file is to define the RegexCache class, a
+ *          thread safe cache of compiled patterns. Every Regex gets its
+ *          program from the process wide cache, so a pattern that keeps
+ *          coming back is only parsed and constructed once, and all the
+ *          Regex objects built from it share one immutable program. Memory
+ *          is bounded by evicting the least recently used programs.
+ */
+
+#include "regex.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+using std::list;
+using std::shared_ptr;
+using std::size_t;
+using std::string;
+using std::unordered_map;
+
+class RegexCache {
+    public:
+        //Default memory budget in bytes.
+        static constexpr size_t kDefaultMemoryBudget = 16 * 1024 * 1024;
+
+        //Ctor.
+        explicit RegexCache(size_t a_memory_budget = kDefaultMemoryBudget);
+        RegexCache(const RegexCache&) = delete;
+        RegexCache& operator=(const RegexCache&) = delete;
+
+        //Returns the process wide cache used by Regex.
+        static RegexCache& GetGlobal(void);
+
+        //Get and set the memory budget, in bytes. Shrinking it evicts
+        //programs right away. A budget of 0 turns caching off.
+        size_t GetMemoryBudget(void) const;
+        void SetMemoryBudget(size_t a_memory_budget);
+
+        //Evicts every program. Regex objects keep the programs they hold.
+        void Clear(void);
+
+        //Counters, safe to read while other threads use the cache.
+        std::uint64_t GetHitCount(void) const;
+        std::uint64_t GetMissCount(void) const;
+        std::uint64_t GetEvictionCount(void) const;
+        size_t GetSize(void) const;
+        size_t GetMemoryUsed(void) const;
+
+    private:
+        //Builds Regex objects from the cache.
+        friend class Regex;
+
+        //Returns the program of "a_pattern", compiling and caching it if
+        //needed. Lookups only take a shared lock. Throws
+        //std::invalid_argument if the pattern is malformed, which is not
+        //cached.
+        shared_ptr<const Regex::Program> Get(const string& a_pattern);
+
+        struct Entry {
+            shared_ptr<const Regex::Program> program;
+            size_t cost; //Estimated memory used by the entry.
+            list<const string*>::iterator position; //The entry's place in "recency".
+        };
+
+        //Evicts least recently used entries until "memory_used" fits in
+        //the budget. Needs the exclusive lock.
+        void Evict(void);
+
+        mutable std::shared_mutex lock; //Guards "entries" and "memory_used".
+        unordered_map<string, Entry> entries;
+        size_t memory_budget;
+        size_t memory_used;
+
+        //Keys of "entries", most recently used first. Hits move their entry
+        //to the front while holding the shared lock and "recency_lock",
+        //everything else changes it under the exclusive lock alone.
+        list<const string*> recency;
+        std::mutex recency_lock;
+
+        std::atomic<std::uint64_t> hits;
+        std::atomic<std::uint64_t> misses;
+        std::atomic<std::uint64_t> evictions;
+};
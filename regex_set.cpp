@@ -0,0 +1,162 @@
+/*
+ * Filename: regex_set.cpp
+ * Programmer: Abdurrahman Alyajouri
+ * Date: 10/17/2026
+ * Purpose: The purpose of this file is to implement the RegexSet class
+ *          declared in "regex_set.h".
+ */
+
+#include "regex_set.h"
+#include "regex.h"
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+//BEGINNING OF REGEXSET CLASS IMPLEMENTATION
+
+RegexSet::RegexSet()
+    : anchored_key(std::make_shared<char>()), unanchored_key(std::make_shared<char>()),
+      cache_budget(LazyDFA::kDefaultCacheBudget) {}
+
+RegexSet::RegexSet(const vector<string>& some_patterns) : RegexSet() {
+    for(const string& a_pattern : some_patterns) Add(a_pattern);
+}
+
+size_t RegexSet::Add(const string& a_pattern) {
+    //Reuse Regex's thompson construction, then hang the resulting NFA off
+    //the union as its own branch, tagging its accept state.
+    Regex re(a_pattern);
+    size_t id = this->patterns.size();
+    this->patterns.push_back(a_pattern);
+    StateId accept = this->nfa.AddBranch(re.program->nfa);
+    this->accept_tags.resize(this->nfa.GetStateCount(), kNoPattern);
+    if(accept != kNoState) this->accept_tags[accept] = static_cast<std::uint32_t>(id);
+
+    //The new branch only adds its own ranges to the byte classes.
+    for(size_t i = 0; i < re.program->nfa.GetStateCount(); ++i) {
+        const State& state = re.program->nfa.GetState(static_cast<StateId>(i));
+        if(state.HasSymbolTransition()) this->byte_classes.AddRange(state.low, state.high);
+    }
+    this->byte_classes.Build();
+
+    this->anchored_key = std::make_shared<char>();
+    this->unanchored_key = std::make_shared<char>();
+    return id;
+}
+
+size_t RegexSet::GetSize(void) const {
+    return this->patterns.size();
+}
+
+const string& RegexSet::GetPattern(size_t id) const {
+    return this->patterns[id];
+}
+
+vector<size_t> RegexSet::Match(string_view input) const {
+    return Run(input, false, this->anchored_key, MatchContext::GetThreadContext(this->cache_budget));
+}
+
+vector<size_t> RegexSet::Match(string_view input, MatchContext& context) const {
+    return Run(input, false, this->anchored_key, context);
+}
+
+vector<size_t> RegexSet::Search(string_view input) const {
+    return Run(input, true, this->unanchored_key, MatchContext::GetThreadContext(this->cache_budget));
+}
+
+vector<size_t> RegexSet::Search(string_view input, MatchContext& context) const {
+    return Run(input, true, this->unanchored_key, context);
+}
+
+size_t RegexSet::GetDFACacheBudget(void) const {
+    return this->cache_budget;
+}
+
+void RegexSet::SetDFACacheBudget(size_t a_cache_budget) {
+    this->cache_budget = a_cache_budget;
+    return;
+}
+
+vector<size_t> RegexSet::Run(string_view input, bool unanchored, const shared_ptr<const void>& key,
+                             MatchContext& context) const {
+    vector<StateId> accepting;
+    LazyDFA::Counters before;
+    LazyDFA& lazy_dfa = context.GetLazyDFA(key, unanchored, before);
+    if(lazy_dfa.Match(this->nfa, this->byte_classes, input, &accepting) == LazyDFA::Result::kGaveUp)
+        MatchNFA(input, unanchored, accepting, context);
+    return ToPatternIds(accepting);
+}
+
+vector<size_t> RegexSet::ToPatternIds(const vector<StateId>& accepting) const {
+    vector<size_t> ids;
+    for(StateId state : accepting)
+        if(this->accept_tags[state] != kNoPattern) ids.push_back(this->accept_tags[state]);
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    return ids;
+}
+
+void RegexSet::MatchNFA(string_view input, bool unanchored, vector<StateId>& accepting,
+                        MatchContext& context) const {
+    accepting.clear();
+    if(this->nfa.IsEmpty()) return;
+
+    //A state is in the current set if its mark equals the step number.
+    vector<size_t>& marks = context.marks;
+    vector<StateId>& current_states = context.current_states;
+    vector<StateId>& next_states = context.next_states;
+    vector<StateId>& pending = context.pending;
+    size_t step = context.ReserveSteps(this->nfa.GetStateCount(), input.size() + 1);
+    current_states.clear();
+
+    //Adds "state" and its epsilon closure to "states".
+    auto add_closure = [&](vector<StateId>& states, StateId state) {
+        if(marks[state] == step) return;
+        marks[state] = step;
+        pending.assign(1, state);
+        while(!pending.empty()) {
+            StateId id = pending.back();
+            pending.pop_back();
+            states.push_back(id);
+            const State& current = this->nfa.GetState(id);
+            for(int i = 0; i < current.epsilon_count; ++i) {
+                StateId next_state = current.epsilon_transitions[i];
+                if(marks[next_state] != step) {
+                    marks[next_state] = step;
+                    pending.push_back(next_state);
+                }
+            }
+        }
+    };
+
+    //Collects the accepting states of the current set.
+    auto report = [&](void) {
+        for(StateId id : current_states)
+            if(this->nfa.GetState(id).acceptance) accepting.push_back(id);
+    };
+
+    add_closure(current_states, this->nfa.GetStartState());
+    for(char c : input) {
+        if(unanchored) report();
+
+        ++step;
+        next_states.clear();
+        for(StateId id : current_states) {
+            const State& state = this->nfa.GetState(id);
+            if(state.Matches(c)) add_closure(next_states, state.symbol_transition);
+        }
+        if(unanchored) add_closure(next_states, this->nfa.GetStartState());
+        current_states.swap(next_states);
+    }
+    report();
+
+    std::sort(accepting.begin(), accepting.end());
+    accepting.erase(std::unique(accepting.begin(), accepting.end()), accepting.end());
+    return;
+}
+
+//END OF REGEXSET CLASS IMPLEMENTATION
@@ -0,0 +1,100 @@
+#pragma once
+
+/*
+ * Filename: regex_set.h
+ * Programmer: Abdurrahman Alyajouri
+ * Date: 10/17/2026
+ * Purpose: The purpose of this file is to define the RegexSet class, which
+ *          unions the thompson constructed NFAs of many patterns into one
+ *          automaton so that a single pass over the input tells which of
+ *          the patterns match it. Like Regex, matching works in a
+ *          MatchContext, so a const RegexSet can be shared by many threads.
+ */
+
+#include "byte_class.h"
+#include "lazy_dfa.h"
+#include "match_context.h"
+#include "tnfa.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using std::shared_ptr;
+using std::size_t;
+using std::string;
+using std::string_view;
+using std::vector;
+
+class RegexSet {
+    public:
+        //Ctor and overloaded ctor.
+        RegexSet();
+        RegexSet(const vector<string>& some_patterns);
+
+        //Adds a pattern to the set. Returns the id of the pattern, which is
+        //the number of patterns added before it. Throws
+        //std::invalid_argument if the pattern is malformed.
+        size_t Add(const string& a_pattern);
+
+        //Returns the number of patterns in the set.
+        size_t GetSize(void) const;
+
+        //Returns the pattern with id "id".
+        const string& GetPattern(size_t id) const;
+
+        //Returns the ids of the patterns that match all of "input", in
+        //increasing order. Only looks for exact matches from the beginning
+        //of a string to the end, like Regex::Match. The first version uses
+        //the calling thread's context, the second one "context".
+        vector<size_t> Match(string_view input) const;
+        vector<size_t> Match(string_view input, MatchContext& context) const;
+
+        //Returns the ids of the patterns that match somewhere in "input",
+        //in increasing order. Contexts work the same as for Match.
+        vector<size_t> Search(string_view input) const;
+        vector<size_t> Search(string_view input, MatchContext& context) const;
+
+        //Get and set the memory budget, in bytes, of the lazy DFA state
+        //caches the set gets in the thread's context, which the calls not
+        //given one use.
+        size_t GetDFACacheBudget(void) const;
+        void SetDFACacheBudget(size_t a_cache_budget);
+
+    private:
+        //Marks states that do not accept any pattern in "accept_tags".
+        static constexpr std::uint32_t kNoPattern = 0xFFFFFFFF;
+
+        //Turns the accepting NFA states that matched into pattern ids.
+        vector<size_t> ToPatternIds(const vector<StateId>& accepting) const;
+
+        //Runs "input" through the lazy DFA of "key" in "context", or the
+        //NFA if its cache is thrashing, and returns the ids of the patterns
+        //that matched.
+        vector<size_t> Run(string_view input, bool unanchored, const shared_ptr<const void>& key,
+                           MatchContext& context) const;
+
+        //Simulates "nfa" directly, for when a lazy DFA's cache is
+        //thrashing. Writes the accepting states that matched to
+        //"accepting".
+        void MatchNFA(string_view input, bool unanchored, vector<StateId>& accepting, MatchContext& context) const;
+
+        vector<string> patterns; //The patterns, indexed by id.
+
+        TNFA nfa; //Union of the NFAs of all patterns.
+        ByteClasses byte_classes; //Byte classes of "nfa".
+
+        //For each state of "nfa", the id of the pattern it is the accept
+        //state of, or kNoPattern.
+        vector<std::uint32_t> accept_tags;
+
+        //Identify the automaton among the lazy DFA caches of a context, one
+        //for Match and one for Search. Add replaces them, so the states
+        //cached for fewer patterns are never used again.
+        shared_ptr<const void> anchored_key;
+        shared_ptr<const void> unanchored_key;
+
+        size_t cache_budget; //Of the calls not given a context.
+};
@@ -0,0 +1,151 @@
+#pragma once
+
+/*
+ * Filename: regex_stats.h
+ * Programmer: Abdurrahman Alyajouri
+ * Date: 10/17/2026
+ * Purpose: The purpose of this file is to define the counters kept on the
+ *          match path and the RegexStats snapshot Regex::GetStats returns.
+ *          Counting is turned on by building with REGEX_ENABLE_STATS
+ *          defined. Without it, RegexCounters is empty, every counting
+ *          statement is discarded at compile time and the match side of a
+ *          snapshot reads zero.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+using std::size_t;
+
+#ifdef REGEX_ENABLE_STATS
+constexpr bool kRegexStatsEnabled = true;
+#else
+constexpr bool kRegexStatsEnabled = false;
+#endif
+
+//A snapshot of what a Regex was built from and what its matches did.
+struct RegexStats {
+    //Compile side. Construction time and the unsimplified NFA are only
+    //measured with stats on.
+    size_t nfa_states;
+    size_t nfa_symbol_edges;
+    size_t nfa_epsilon_edges;
+    size_t epsilon_free_states; //0 if the epsilon free NFA wasn't built.
+    size_t epsilon_free_edges;
+    size_t glushkov_positions; //0 if the pattern is too big for BitParallelNFA.
+    size_t literal_states; //0 unless the pattern is an alternation of literals.
+    size_t required_literal_length; //0 if Find has no literal to skip ahead to.
+    double construction_us; //Parsing and building the program.
+    size_t unsimplified_nfa_states; //What "nfa_states" would be without simplifying the pattern.
+
+    //Match side, counted since the Regex was built or ResetStats.
+    std::uint64_t match_calls;
+    std::uint64_t find_calls;
+    std::uint64_t bytes_scanned;
+    std::uint64_t bytes_skipped; //By Find, skipping ahead to the required literal.
+
+    //Which engine Match calls ended up on.
+    std::uint64_t literal_matches;
+    std::uint64_t bit_parallel_matches;
+    std::uint64_t dfa_matches;
+    std::uint64_t nfa_matches; //Includes lazy DFA fallbacks.
+
+    //NFA simulation, in Match fallbacks and Find. "active_states" is summed
+    //over all steps, so "active_states / nfa_steps" is the average per step.
+    std::uint64_t nfa_steps;
+    std::uint64_t active_states;
+    std::uint64_t max_active_states;
+    std::uint64_t closure_expansions; //States added by epsilon closures.
+
+    //Lazy DFA cache.
+    std::uint64_t dfa_cache_hits; //Transitions found in the table.
+    std::uint64_t dfa_cache_misses; //Transitions that had to be built.
+    std::uint64_t dfa_cache_flushes;
+};
+
+//Counters updated by the const match functions of a Regex, possibly from
+//many threads at once. Each call adds up its counts locally and adds them
+//in here once at the end with relaxed atomics. Every thread counts in one
+//of kShardCount shards, each on cache lines of its own, so threads
+//matching the same Regex don't contend for them, and Get sums the shards
+//up. Copies start from zero, since the counts describe the object they
+//were taken on. With stats off the class is empty.
+class RegexCounters {
+    public:
+        enum Counter {
+            kMatchCalls, kFindCalls, kBytesScanned, kBytesSkipped, kLiteralMatches, kBitParallelMatches,
+            kDFAMatches, kNFAMatches, kNFASteps, kActiveStates, kMaxActiveStates, kClosureExpansions,
+            kDFALookups, kDFAMisses, kDFAFlushes,
+            kCounterCount
+        };
+
+        //Number of shards the counts are spread over.
+        static constexpr size_t kShardCount = 8;
+
+        RegexCounters() { Reset(); }
+        RegexCounters(const RegexCounters&) : RegexCounters() {}
+        RegexCounters& operator=(const RegexCounters&) { Reset(); return *this; }
+
+        //Adds "amount" to counter "which". Does nothing with stats off.
+        void Add(Counter which, std::uint64_t amount) {
+#ifdef REGEX_ENABLE_STATS
+            GetShard().values[which].fetch_add(amount, std::memory_order_relaxed);
+#else
+            (void)which;
+            (void)amount;
+#endif
+        }
+
+        //Raises counter "which" to "amount" if it is lower.
+        void Max(Counter which, std::uint64_t amount) {
+#ifdef REGEX_ENABLE_STATS
+            std::atomic<std::uint64_t>& value = GetShard().values[which];
+            std::uint64_t current = value.load(std::memory_order_relaxed);
+            while(current < amount && !value.compare_exchange_weak(current, amount, std::memory_order_relaxed)) {}
+#else
+            (void)which;
+            (void)amount;
+#endif
+        }
+
+        //Returns the total of counter "which", or the largest value of the
+        //shards for kMaxActiveStates.
+        std::uint64_t Get(Counter which) const {
+            std::uint64_t total = 0;
+#ifdef REGEX_ENABLE_STATS
+            for(const Shard& shard : this->shards) {
+                std::uint64_t value = shard.values[which].load(std::memory_order_relaxed);
+                total = which == kMaxActiveStates ? std::max(total, value) : total + value;
+            }
+#else
+            (void)which;
+#endif
+            return total;
+        }
+
+        void Reset(void) {
+#ifdef REGEX_ENABLE_STATS
+            for(Shard& shard : this->shards)
+                for(std::atomic<std::uint64_t>& value : shard.values) value.store(0, std::memory_order_relaxed);
+#endif
+        }
+
+#ifdef REGEX_ENABLE_STATS
+    private:
+        struct alignas(64) Shard {
+            std::atomic<std::uint64_t> values[kCounterCount];
+        };
+
+        //Returns the shard of the calling thread. Threads take the shards
+        //in turn, the first time they count anything.
+        Shard& GetShard(void) {
+            static std::atomic<size_t> next_shard(0);
+            thread_local size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % kShardCount;
+            return this->shards[shard];
+        }
+
+        Shard shards[kShardCount];
+#endif
+};
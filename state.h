@@ -1,35 +1,75 @@
 #pragma once
 
 /*
- * Filename: state.h 
+ * Filename: state.h
  * Programmer: Abdurrahman Alyajouri
  * Date: 11/24/2025
  * Purpose: The purpose of this file is to define the State struct.
  */
 
-#include <vector>
-#include <unordered_map>
+#include <cassert>
+#include <cstdint>
 
+//States live in one contiguous array owned by their TNFA and refer to each
+//other by their index in that array.
+typedef std::uint32_t StateId;
+
+//Marks the absence of a state, e.g. the start state of an empty TNFA.
+constexpr StateId kNoState = 0xFFFFFFFF;
+
+//Thompson's construction never gives a state more than one symbol transition
+//or more than two epsilon transitions, so every transition is stored inline
+//and a state is a small fixed size record with no allocations of its own.
+//A symbol transition matches an inclusive range of bytes.
 struct State {
     //Ctors.
-    State() : acceptance(false) {}
-    State(bool an_acceptance) : acceptance(an_acceptance) {}
-    
+    State() : State(false) {}
+    State(bool an_acceptance)
+        : acceptance(an_acceptance), epsilon_count(0), low(0), high(0),
+          symbol_transition(kNoState), epsilon_transitions{kNoState, kNoState} {}
+
     //Insertion wrappers for clarity.
-    void AddSymbolTransition(State* destination, char symbol) {
-        this->symbol_transitions[symbol].push_back(destination);
+    void AddSymbolTransition(StateId destination, char symbol) {
+        AddRangeTransition(destination, static_cast<unsigned char>(symbol),
+                           static_cast<unsigned char>(symbol));
+    }
+
+    void AddRangeTransition(StateId destination, unsigned char a_low, unsigned char a_high) {
+        assert(!HasSymbolTransition());
+        this->low = a_low;
+        this->high = a_high;
+        this->symbol_transition = destination;
+    }
+
+    void AddEpsilonTransition(StateId destination) {
+        assert(this->epsilon_count < 2);
+        this->epsilon_transitions[this->epsilon_count++] = destination;
     }
-    
-    void AddEpsilonTransition(State* destination) {
-        this->epsilon_transitions.push_back(destination);
+
+    //Returns true if the state has a symbol transition.
+    bool HasSymbolTransition(void) const {
+        return this->symbol_transition != kNoState;
     }
-    
+
+    //Returns true if the symbol transition can be taken on byte "c".
+    bool Matches(char c) const {
+        unsigned char byte = static_cast<unsigned char>(c);
+        return HasSymbolTransition() && this->low <= byte && byte <= this->high;
+    }
+
     //Tracks whether the state is accepting state or not.
-    bool acceptance; 
-    
-    //Tracks symbol transitions.
-    std::unordered_map<char, std::vector<State*>> symbol_transitions; 
-    
+    bool acceptance;
+
+    //Number of entries of "epsilon_transitions" in use.
+    std::uint8_t epsilon_count;
+
+    //Range of bytes, inclusive, the symbol transition is taken on.
+    unsigned char low;
+    unsigned char high;
+
+    //Tracks the symbol transition, kNoState if there is none.
+    StateId symbol_transition;
+
     //Tracks states accessible via epsilon transitions.
-    std::vector<State*> epsilon_transitions; 
+    StateId epsilon_transitions[2];
 };
@@ -0,0 +1,726 @@
+#pragma once
+
+/*
+ * Filename: static_regex.h
+ * Programmer: Abdurrahman Alyajouri
+ * Date: 10/17/2026
+ * Purpose: The purpose of this file is to define the StaticRegex class
+ *          template, which runs the same pipeline as Regex (tokenizing,
+ *          making concatenations explicit, the shunting yard algorithm and
+ *          thompsons construction) followed by the subset construction
+ *          while the program is being compiled. The result is a constexpr
+ *          transition table, so a StaticRegex costs nothing to construct
+ *          and its match loop is specialized for its pattern.
+ *
+ *          In C++20 the pattern is a string literal:
+ *              StaticRegex<"((Hello)|(Hi)) Worlds*">::Match(input)
+ *
+ *          C++17 can't take a string literal as a template argument, so
+ *          the pattern has to be a constexpr character array instead, which
+ *          works in C++20 as well:
+ *              static constexpr char kGreeting[] = "((Hello)|(Hi)) Worlds*";
+ *              StaticRegex<kGreeting>::Match(input)
+ *
+ *          A malformed pattern, or one that needs more DFA states than
+ *          allowed, is a compile error.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+using std::size_t;
+using std::string_view;
+
+//Default limit on the number of DFA states a StaticRegex may build.
+constexpr size_t kStaticRegexMaxStates = 256;
+
+//A set of bytes usable in constant expressions, like ByteSet.
+class StaticByteSet {
+    public:
+        //Ctor, creates an empty set.
+        constexpr StaticByteSet() : words{0, 0, 0, 0} {}
+
+        //Insertion.
+        constexpr void Add(unsigned char c) {
+            this->words[c / 64] |= std::uint64_t(1) << (c % 64);
+        }
+
+        constexpr void AddRange(unsigned char low, unsigned char high) {
+            for(unsigned int c = low; c <= high; ++c) Add(static_cast<unsigned char>(c));
+        }
+
+        constexpr void AddSet(const StaticByteSet& a_set) {
+            for(int i = 0; i < 4; ++i) this->words[i] |= a_set.words[i];
+        }
+
+        //Replaces the set with every byte that is not in it.
+        constexpr void Negate(void) {
+            for(int i = 0; i < 4; ++i) this->words[i] = ~this->words[i];
+        }
+
+        //Queries.
+        constexpr bool Contains(unsigned char c) const {
+            return (this->words[c / 64] >> (c % 64)) & 1;
+        }
+
+        constexpr size_t GetCount(void) const {
+            size_t count = 0;
+            for(unsigned int c = 0; c < 256; ++c) count += Contains(static_cast<unsigned char>(c));
+            return count;
+        }
+
+        //Returns the smallest byte in the set, or 0 if it is empty.
+        constexpr unsigned char GetFirst(void) const {
+            for(unsigned int c = 0; c < 256; ++c)
+                if(Contains(static_cast<unsigned char>(c))) return static_cast<unsigned char>(c);
+            return 0;
+        }
+
+    private:
+        std::uint64_t words[4]; //Bit c % 64 of word c / 64 is set if c is in the set.
+};
+
+//The thompson constructed NFA of a pattern of "kLength" bytes, built in a
+//constant expression. Every symbol and operator adds at most two states, so
+//the states fit in a fixed size array. Unlike TNFA, a symbol transition
+//matches any set of bytes, so a character class is a single state.
+template <size_t kLength>
+class StaticNFA {
+    public:
+        static constexpr size_t kCapacity = 2 * kLength + 1;
+
+        struct Node {
+            StaticByteSet symbols; //The bytes the symbol transition matches.
+            bool has_symbol = false;
+            std::uint32_t symbol_transition = 0;
+            std::uint8_t epsilon_count = 0;
+            std::uint32_t epsilon_transitions[2] = {0, 0};
+        };
+
+        //Ctor, builds the NFA of the first "kLength" bytes of "a_pattern".
+        //Throws std::invalid_argument if the pattern is malformed, which
+        //during constant evaluation is a compile error.
+        constexpr StaticNFA(const char* a_pattern) : states{}, state_count(0), start_state(0), accept_state(0) {
+            DoThompsonsConstruction(a_pattern);
+        }
+
+        //Getters.
+        constexpr size_t GetStateCount(void) const { return this->state_count; }
+        constexpr std::uint32_t GetStartState(void) const { return this->start_state; }
+        constexpr std::uint32_t GetAcceptState(void) const { return this->accept_state; }
+        constexpr const Node& GetState(size_t id) const { return this->states[id]; }
+
+    private:
+        //Same tokens as Regex::Token, except that groups don't capture and
+        //there is no counted repetition.
+        struct Token {
+            enum class Type { kSymbol, kConcatenation, kAlternation, kKleeneClosure,
+                              kOneOrMore, kZeroOrOne, kLeftParenthesis, kRightParenthesis };
+
+            Type type = Type::kSymbol;
+            StaticByteSet symbols; //The bytes a kSymbol token matches.
+        };
+
+        //Every pattern byte makes at most one token, and making
+        //concatenations explicit at most doubles them.
+        static constexpr size_t kMaxTokens = 2 * kLength + 1;
+
+        //Splits the pattern into "tokens", like Regex::Tokenize. Returns
+        //the number of tokens.
+        static constexpr size_t Tokenize(const char* a_pattern, Token* tokens) {
+            size_t count = 0;
+            size_t i = 0;
+            while(i < kLength) {
+                Token token;
+                switch(a_pattern[i]) {
+                    case '|': token.type = Token::Type::kAlternation; ++i; break;
+                    case '*': token.type = Token::Type::kKleeneClosure; ++i; break;
+                    case '+': token.type = Token::Type::kOneOrMore; ++i; break;
+                    case '?': token.type = Token::Type::kZeroOrOne; ++i; break;
+                    case '(':
+                        token.type = Token::Type::kLeftParenthesis;
+                        i += i + 2 < kLength && a_pattern[i + 1] == '?' && a_pattern[i + 2] == ':' ? 3 : 1;
+                        break;
+                    case '{':
+                        //Each copy of a repeated operand would need room the
+                        //fixed size state array doesn't have.
+                        if(IsRepetition(a_pattern, i))
+                            throw std::invalid_argument("Counted repetition is not supported by StaticRegex.");
+                        token.symbols.Add('{');
+                        ++i;
+                        break;
+                    case ')': token.type = Token::Type::kRightParenthesis; ++i; break;
+                    case '\\': i = ParseEscape(a_pattern, i, token.symbols); break;
+                    case '[': i = ParseClass(a_pattern, i, token.symbols); break;
+                    case '.':
+                        token.symbols.Add('\n');
+                        token.symbols.Negate();
+                        ++i;
+                        break;
+                    default:
+                        token.symbols.Add(static_cast<unsigned char>(a_pattern[i]));
+                        ++i;
+                        break;
+                }
+                tokens[count++] = token;
+            }
+            return count;
+        }
+
+        //Returns true if the '{' at "a_pattern[i]" starts {m}, {m,} or
+        //{m,n}, which Regex::ParseRepetition would parse.
+        static constexpr bool IsRepetition(const char* a_pattern, size_t i) {
+            size_t j = i + 1;
+            auto skip_digits = [&](void) {
+                size_t first = j;
+                while(j < kLength && a_pattern[j] >= '0' && a_pattern[j] <= '9') ++j;
+                return j > first;
+            };
+            if(!skip_digits()) return false;
+            if(j < kLength && a_pattern[j] == ',') {
+                ++j;
+                skip_digits();
+            }
+            return j < kLength && a_pattern[j] == '}';
+        }
+
+        //Same as Regex::ParseEscape.
+        static constexpr size_t ParseEscape(const char* a_pattern, size_t i, StaticByteSet& symbols) {
+            if(i + 1 >= kLength) throw std::invalid_argument("Pattern ends with a '\\'.");
+
+            char c = a_pattern[i + 1];
+            StaticByteSet escaped;
+            switch(c) {
+                case 'd': case 'D':
+                    escaped.AddRange('0', '9');
+                    break;
+                case 'w': case 'W':
+                    escaped.AddRange('0', '9');
+                    escaped.AddRange('A', 'Z');
+                    escaped.AddRange('a', 'z');
+                    escaped.Add('_');
+                    break;
+                case 's': case 'S':
+                    escaped.AddRange('\t', '\r'); //\t \n \v \f \r
+                    escaped.Add(' ');
+                    break;
+                case 'n': escaped.Add('\n'); break;
+                case 't': escaped.Add('\t'); break;
+                case 'r': escaped.Add('\r'); break;
+                case 'f': escaped.Add('\f'); break;
+                case 'v': escaped.Add('\v'); break;
+                case 'x': {
+                        //Exactly two hex digits.
+                        int value = 0;
+                        for(size_t j = i + 2; j < i + 4; ++j) {
+                            char digit = j < kLength ? a_pattern[j] : '\0';
+                            if(digit >= '0' && digit <= '9') value = value * 16 + (digit - '0');
+                            else if(digit >= 'a' && digit <= 'f') value = value * 16 + (digit - 'a' + 10);
+                            else if(digit >= 'A' && digit <= 'F') value = value * 16 + (digit - 'A' + 10);
+                            else throw std::invalid_argument("Expected two hex digits after '\\x'.");
+                        }
+                        symbols.Add(static_cast<unsigned char>(value));
+                        return i + 4;
+                    }
+                default:
+                    escaped.Add(static_cast<unsigned char>(c));
+                    break;
+            }
+
+            if(c == 'D' || c == 'W' || c == 'S') escaped.Negate();
+            symbols.AddSet(escaped);
+            return i + 2;
+        }
+
+        //Same as Regex::ParseClass.
+        static constexpr size_t ParseClass(const char* a_pattern, size_t i, StaticByteSet& symbols) {
+            ++i; //Skip '['.
+            bool negated = i < kLength && a_pattern[i] == '^';
+            if(negated) ++i;
+
+            bool first = true;
+            while(i < kLength && (a_pattern[i] != ']' || first)) {
+                first = false;
+
+                StaticByteSet item;
+                bool is_byte = true;
+                unsigned char low = static_cast<unsigned char>(a_pattern[i]);
+                if(a_pattern[i] == '\\') {
+                    i = ParseEscape(a_pattern, i, item);
+                    is_byte = item.GetCount() == 1;
+                    if(is_byte) low = item.GetFirst();
+                } else {
+                    item.Add(low);
+                    ++i;
+                }
+
+                if(is_byte && i + 1 < kLength && a_pattern[i] == '-' && a_pattern[i + 1] != ']') {
+                    StaticByteSet upper;
+                    unsigned char high = static_cast<unsigned char>(a_pattern[i + 1]);
+                    if(a_pattern[i + 1] == '\\') {
+                        i = ParseEscape(a_pattern, i + 1, upper);
+                        if(upper.GetCount() != 1) throw std::invalid_argument("Invalid range in character class.");
+                        high = upper.GetFirst();
+                    } else {
+                        i += 2;
+                    }
+                    if(high < low) throw std::invalid_argument("Invalid range in character class.");
+                    item.AddRange(low, high);
+                }
+
+                symbols.AddSet(item);
+            }
+
+            if(i >= kLength) throw std::invalid_argument("Missing ']' in character class.");
+            if(negated) symbols.Negate();
+            return i + 1; //Skip ']'.
+        }
+
+        //Same as Regex::MakeConcatenationExplicit, writing to "result".
+        //Returns the number of tokens written.
+        static constexpr size_t MakeConcatenationExplicit(const Token* tokens, size_t count, Token* result) {
+            size_t result_count = 0;
+            for(size_t i = 0; i < count; ++i) {
+                if(i > 0) {
+                    typename Token::Type previous = tokens[i - 1].type;
+                    typename Token::Type current = tokens[i].type;
+                    if(!(previous == Token::Type::kAlternation || previous == Token::Type::kLeftParenthesis ||
+                         previous == Token::Type::kConcatenation) &&
+                       !(current == Token::Type::kAlternation || current == Token::Type::kKleeneClosure ||
+                         current == Token::Type::kOneOrMore || current == Token::Type::kZeroOrOne ||
+                         current == Token::Type::kRightParenthesis || current == Token::Type::kConcatenation)) {
+                        Token concatenation;
+                        concatenation.type = Token::Type::kConcatenation;
+                        result[result_count++] = concatenation;
+                    }
+                }
+                result[result_count++] = tokens[i];
+            }
+            return result_count;
+        }
+
+        //Operator precedence for the shunting yard algorithm.
+        static constexpr int GetPrecedence(typename Token::Type type) {
+            switch(type) {
+                case Token::Type::kKleeneClosure: return 3;
+                case Token::Type::kOneOrMore: return 3;
+                case Token::Type::kZeroOrOne: return 3;
+                case Token::Type::kConcatenation: return 2;
+                case Token::Type::kAlternation: return 1;
+                default: return 0;
+            }
+        }
+
+        //Same as Regex::RegexToPostFix, writing to "output". Returns the
+        //number of tokens written.
+        static constexpr size_t RegexToPostFix(const char* a_pattern, Token* output) {
+            Token tokens[kMaxTokens] = {};
+            Token explicit_tokens[kMaxTokens] = {};
+            Token operators[kMaxTokens] = {};
+            size_t operator_count = 0;
+            size_t output_count = 0;
+
+            size_t count = MakeConcatenationExplicit(tokens, Tokenize(a_pattern, tokens), explicit_tokens);
+            for(size_t i = 0; i < count; ++i) {
+                const Token& token = explicit_tokens[i];
+                switch(token.type) {
+                    case Token::Type::kKleeneClosure:
+                    case Token::Type::kOneOrMore:
+                    case Token::Type::kZeroOrOne:
+                    case Token::Type::kConcatenation:
+                    case Token::Type::kAlternation:
+                        while(operator_count > 0 &&
+                              GetPrecedence(token.type) <= GetPrecedence(operators[operator_count - 1].type))
+                            output[output_count++] = operators[--operator_count];
+                        operators[operator_count++] = token;
+                        break;
+                    case Token::Type::kLeftParenthesis:
+                        operators[operator_count++] = token;
+                        break;
+                    case Token::Type::kRightParenthesis:
+                        while(operator_count > 0 && operators[operator_count - 1].type != Token::Type::kLeftParenthesis)
+                            output[output_count++] = operators[--operator_count];
+                        if(operator_count == 0) throw std::invalid_argument("Unbalanced ')' in pattern.");
+                        --operator_count;
+                        break;
+                    default:
+                        output[output_count++] = token;
+                        break;
+                }
+            }
+            while(operator_count > 0) {
+                if(operators[operator_count - 1].type == Token::Type::kLeftParenthesis)
+                    throw std::invalid_argument("Unbalanced '(' in pattern.");
+                output[output_count++] = operators[--operator_count];
+            }
+            return output_count;
+        }
+
+        constexpr std::uint32_t AddState(void) {
+            return static_cast<std::uint32_t>(this->state_count++);
+        }
+
+        constexpr void AddEpsilonTransition(std::uint32_t from, std::uint32_t to) {
+            Node& node = this->states[from];
+            node.epsilon_transitions[node.epsilon_count++] = to;
+        }
+
+        //Same as Regex::DoThompsonsConstruction. A fragment's accept state
+        //never has transitions of its own until an operator links it up,
+        //so no state ends up with more than two epsilon transitions.
+        constexpr void DoThompsonsConstruction(const char* a_pattern) {
+            struct Fragment {
+                std::uint32_t start = 0;
+                std::uint32_t accept = 0;
+            };
+
+            Token postfix[kMaxTokens] = {};
+            Fragment fragments[kLength + 1] = {};
+            size_t fragment_count = 0;
+
+            size_t count = RegexToPostFix(a_pattern, postfix);
+            for(size_t i = 0; i < count; ++i) {
+                const Token& token = postfix[i];
+                size_t operands = token.type == Token::Type::kSymbol ? 0 :
+                                  token.type == Token::Type::kKleeneClosure || token.type == Token::Type::kOneOrMore ||
+                                  token.type == Token::Type::kZeroOrOne ? 1 : 2;
+                if(fragment_count < operands) throw std::invalid_argument("Operator is missing an operand.");
+
+                switch(token.type) {
+                    case Token::Type::kKleeneClosure: {
+                            Fragment& operand = fragments[fragment_count - 1];
+                            std::uint32_t start = AddState();
+                            std::uint32_t accept = AddState();
+                            AddEpsilonTransition(start, operand.start);
+                            AddEpsilonTransition(start, accept);
+                            AddEpsilonTransition(operand.accept, operand.start);
+                            AddEpsilonTransition(operand.accept, accept);
+                            operand = Fragment{start, accept};
+                        }
+                        break;
+                    case Token::Type::kOneOrMore: {
+                            Fragment& operand = fragments[fragment_count - 1];
+                            std::uint32_t accept = AddState();
+                            AddEpsilonTransition(operand.accept, operand.start);
+                            AddEpsilonTransition(operand.accept, accept);
+                            operand.accept = accept;
+                        }
+                        break;
+                    case Token::Type::kZeroOrOne: {
+                            Fragment& operand = fragments[fragment_count - 1];
+                            std::uint32_t start = AddState();
+                            AddEpsilonTransition(start, operand.start);
+                            AddEpsilonTransition(start, operand.accept);
+                            operand.start = start;
+                        }
+                        break;
+                    case Token::Type::kConcatenation: {
+                            Fragment rhs = fragments[--fragment_count];
+                            Fragment& lhs = fragments[fragment_count - 1];
+                            AddEpsilonTransition(lhs.accept, rhs.start);
+                            lhs.accept = rhs.accept;
+                        }
+                        break;
+                    case Token::Type::kAlternation: {
+                            Fragment rhs = fragments[--fragment_count];
+                            Fragment& lhs = fragments[fragment_count - 1];
+                            std::uint32_t start = AddState();
+                            std::uint32_t accept = AddState();
+                            AddEpsilonTransition(start, lhs.start);
+                            AddEpsilonTransition(start, rhs.start);
+                            AddEpsilonTransition(lhs.accept, accept);
+                            AddEpsilonTransition(rhs.accept, accept);
+                            lhs = Fragment{start, accept};
+                        }
+                        break;
+                    default: {
+                            std::uint32_t start = AddState();
+                            std::uint32_t accept = AddState();
+                            Node& node = this->states[start];
+                            node.has_symbol = true;
+                            node.symbols = token.symbols;
+                            node.symbol_transition = accept;
+                            fragments[fragment_count++] = Fragment{start, accept};
+                        }
+                        break;
+                }
+            }
+
+            //An empty pattern only matches the empty string.
+            if(fragment_count == 0) {
+                this->start_state = this->accept_state = AddState();
+            } else if(fragment_count > 1) {
+                throw std::invalid_argument("Operand is missing an operator.");
+            } else {
+                this->start_state = fragments[0].start;
+                this->accept_state = fragments[0].accept;
+            }
+        }
+
+        Node states[kCapacity];
+        size_t state_count;
+        std::uint32_t start_state;
+        std::uint32_t accept_state;
+};
+
+//The byte classes of a StaticNFA, like ByteClasses.
+class StaticByteClasses {
+    public:
+        template <size_t kLength>
+        constexpr StaticByteClasses(const StaticNFA<kLength>& nfa) : classes{}, representatives{}, count(0) {
+            //Byte c and c + 1 differ if some transition matches only one
+            //of them.
+            bool boundaries[256] = {};
+            for(size_t id = 0; id < nfa.GetStateCount(); ++id) {
+                const auto& node = nfa.GetState(id);
+                if(!node.has_symbol) continue;
+                for(unsigned int c = 0; c < 255; ++c)
+                    if(node.symbols.Contains(static_cast<unsigned char>(c)) !=
+                       node.symbols.Contains(static_cast<unsigned char>(c + 1)))
+                        boundaries[c] = true;
+            }
+
+            this->representatives[0] = 0;
+            for(unsigned int c = 0; c < 256; ++c) {
+                this->classes[c] = static_cast<unsigned char>(this->count);
+                if(c == 255 || boundaries[c]) {
+                    ++this->count;
+                    if(c < 255) this->representatives[this->count] = static_cast<unsigned char>(c + 1);
+                }
+            }
+        }
+
+        constexpr unsigned char Get(unsigned char c) const { return this->classes[c]; }
+        constexpr size_t GetCount(void) const { return this->count; }
+        constexpr unsigned char GetRepresentative(size_t a_class) const { return this->representatives[a_class]; }
+
+    private:
+        unsigned char classes[256]; //Class of each byte.
+        unsigned char representatives[256]; //A byte of each class.
+        size_t count; //Number of classes.
+};
+
+//Runs the subset construction on a StaticNFA with room for "kMaxStates" DFA
+//states, then merges every state that can't reach an accepting state into
+//a single dead state, so that matching can stop as soon as it is entered.
+template <size_t kLength, size_t kClassCount, size_t kMaxStates>
+class StaticSubsetConstruction {
+    public:
+        //Marks the absence of a dead state.
+        static constexpr std::uint32_t kNoDeadState = 0xFFFFFFFF;
+
+        //Ctor. Throws std::length_error if more than "kMaxStates" states
+        //are needed, which during constant evaluation is a compile error.
+        constexpr StaticSubsetConstruction(const StaticNFA<kLength>& nfa, const StaticByteClasses& classes)
+            : sets{}, transitions{}, accepting{}, live{}, ids{}, origins{},
+              set_count(0), state_count(0), dead_state(kNoDeadState) {
+            std::uint64_t start[kWords] = {};
+            AddClosure(nfa, start, nfa.GetStartState());
+            FindOrAddSet(nfa, start);
+
+            for(size_t current = 0; current < this->set_count; ++current) {
+                for(size_t k = 0; k < kClassCount; ++k) {
+                    unsigned char byte = classes.GetRepresentative(k);
+                    std::uint64_t next[kWords] = {};
+                    for(size_t id = 0; id < nfa.GetStateCount(); ++id) {
+                        if(!((this->sets[current][id / 64] >> (id % 64)) & 1)) continue;
+                        const auto& node = nfa.GetState(id);
+                        if(node.has_symbol && node.symbols.Contains(byte))
+                            AddClosure(nfa, next, node.symbol_transition);
+                    }
+                    this->transitions[current * kClassCount + k] = FindOrAddSet(nfa, next);
+                }
+            }
+
+            //A state is live if it accepts or can move to a live state.
+            for(size_t s = 0; s < this->set_count; ++s) this->live[s] = this->accepting[s];
+            for(bool changed = true; changed; ) {
+                changed = false;
+                for(size_t s = 0; s < this->set_count; ++s) {
+                    if(this->live[s]) continue;
+                    for(size_t k = 0; k < kClassCount && !this->live[s]; ++k)
+                        this->live[s] = this->live[this->transitions[s * kClassCount + k]];
+                    changed = changed || this->live[s];
+                }
+            }
+
+            //Number the live states in the order they were found and give
+            //all others the id right after them.
+            for(size_t s = 0; s < this->set_count; ++s) {
+                if(!this->live[s]) continue;
+                this->origins[this->state_count] = static_cast<std::uint32_t>(s);
+                this->ids[s] = static_cast<std::uint32_t>(this->state_count++);
+            }
+            if(this->state_count < this->set_count) {
+                this->dead_state = static_cast<std::uint32_t>(this->state_count);
+                for(size_t s = 0; s < this->set_count; ++s)
+                    if(!this->live[s]) this->ids[s] = this->dead_state;
+                ++this->state_count;
+            }
+        }
+
+        //Getters, in terms of the renumbered states.
+        constexpr size_t GetStateCount(void) const { return this->state_count; }
+        constexpr std::uint32_t GetStartState(void) const { return this->ids[0]; }
+        constexpr std::uint32_t GetDeadState(void) const { return this->dead_state; }
+
+        constexpr bool IsAccepting(size_t state) const {
+            return state != this->dead_state && this->accepting[this->origins[state]];
+        }
+
+        constexpr std::uint32_t GetTransition(size_t state, size_t a_class) const {
+            if(state == this->dead_state) return this->dead_state;
+            return this->ids[this->transitions[this->origins[state] * kClassCount + a_class]];
+        }
+
+    private:
+        static constexpr size_t kWords = (StaticNFA<kLength>::kCapacity + 63) / 64;
+
+        //Adds "state" and every state reachable from it via epsilon
+        //transitions to "set".
+        static constexpr void AddClosure(const StaticNFA<kLength>& nfa, std::uint64_t* set, std::uint32_t state) {
+            std::uint32_t pending[StaticNFA<kLength>::kCapacity] = {};
+            size_t pending_count = 0;
+            if((set[state / 64] >> (state % 64)) & 1) return;
+            set[state / 64] |= std::uint64_t(1) << (state % 64);
+            pending[pending_count++] = state;
+            while(pending_count > 0) {
+                const auto& node = nfa.GetState(pending[--pending_count]);
+                for(int i = 0; i < node.epsilon_count; ++i) {
+                    std::uint32_t next_state = node.epsilon_transitions[i];
+                    if((set[next_state / 64] >> (next_state % 64)) & 1) continue;
+                    set[next_state / 64] |= std::uint64_t(1) << (next_state % 64);
+                    pending[pending_count++] = next_state;
+                }
+            }
+        }
+
+        //Returns the index of "set" among the sets found so far, adding it
+        //if it is new.
+        constexpr std::uint32_t FindOrAddSet(const StaticNFA<kLength>& nfa, const std::uint64_t* set) {
+            for(size_t s = 0; s < this->set_count; ++s) {
+                bool equal = true;
+                for(size_t w = 0; w < kWords && equal; ++w) equal = this->sets[s][w] == set[w];
+                if(equal) return static_cast<std::uint32_t>(s);
+            }
+
+            if(this->set_count == kMaxStates)
+                throw std::length_error("Pattern needs more DFA states than the StaticRegex allows.");
+            for(size_t w = 0; w < kWords; ++w) this->sets[this->set_count][w] = set[w];
+            std::uint32_t accept = nfa.GetAcceptState();
+            this->accepting[this->set_count] = (set[accept / 64] >> (accept % 64)) & 1;
+            return static_cast<std::uint32_t>(this->set_count++);
+        }
+
+        std::uint64_t sets[kMaxStates][kWords]; //NFA states of each DFA state.
+        std::uint32_t transitions[kMaxStates * kClassCount]; //Indexed by set.
+        bool accepting[kMaxStates];
+        bool live[kMaxStates];
+        std::uint32_t ids[kMaxStates]; //Renumbered id of each set.
+        std::uint32_t origins[kMaxStates]; //Set of each renumbered id.
+        size_t set_count;
+        size_t state_count;
+        std::uint32_t dead_state;
+};
+
+//The final transition table, sized exactly and using the smallest state id
+//type that fits.
+template <typename StateType, size_t kStateCount, size_t kClassCount>
+struct StaticDFATable {
+    template <typename Construction>
+    constexpr StaticDFATable(const StaticByteClasses& classes, const Construction& construction)
+        : byte_classes{}, transitions{}, accepting{}, start_state(construction.GetStartState()) {
+        for(unsigned int c = 0; c < 256; ++c) this->byte_classes[c] = classes.Get(static_cast<unsigned char>(c));
+        for(size_t s = 0; s < kStateCount; ++s) {
+            this->accepting[s] = construction.IsAccepting(s);
+            for(size_t k = 0; k < kClassCount; ++k)
+                this->transitions[s * kClassCount + k] = static_cast<StateType>(construction.GetTransition(s, k));
+        }
+    }
+
+    unsigned char byte_classes[256]; //Class of each byte.
+    StateType transitions[kStateCount * kClassCount]; //One row per state.
+    bool accepting[kStateCount];
+    StateType start_state;
+};
+
+//A regex compiled to a DFA during compilation. "Source" supplies the
+//pattern through "Source::Get()" and "Source::kLength". Use the StaticRegex
+//alias below rather than naming this directly.
+template <typename Source, size_t kMaxStates>
+class BasicStaticRegex {
+    private:
+        static constexpr StaticNFA<Source::kLength> kNFA{Source::Get()};
+        static constexpr StaticByteClasses kClasses{kNFA};
+        static constexpr size_t kClassCount = kClasses.GetCount();
+        static constexpr StaticSubsetConstruction<Source::kLength, kClassCount, kMaxStates> kConstruction{kNFA, kClasses};
+        static constexpr size_t kStateCount = kConstruction.GetStateCount();
+
+        typedef std::conditional_t<(kStateCount <= 0xFF), std::uint8_t,
+                std::conditional_t<(kStateCount <= 0xFFFF), std::uint16_t, std::uint32_t>> StateType;
+
+        static constexpr StaticDFATable<StateType, kStateCount, kClassCount> kTable{kClasses, kConstruction};
+        static constexpr bool kHasDeadState = kConstruction.GetDeadState() != kConstruction.kNoDeadState;
+        static constexpr StateType kDeadState = static_cast<StateType>(kConstruction.GetDeadState());
+
+    public:
+        //Returns the pattern.
+        static constexpr string_view GetPattern(void) {
+            return string_view(Source::Get(), Source::kLength);
+        }
+
+        //Checks if the whole input is matched, like Regex::Match. Can be
+        //used in constant expressions too.
+        static constexpr bool Match(string_view input) {
+            StateType state = kTable.start_state;
+            for(char c : input) {
+                state = kTable.transitions[state * kClassCount + kTable.byte_classes[static_cast<unsigned char>(c)]];
+                if constexpr(kHasDeadState) {
+                    if(state == kDeadState) return false;
+                }
+            }
+            return kTable.accepting[state];
+        }
+
+        //Returns the number of DFA states and byte classes.
+        static constexpr size_t GetStateCount(void) { return kStateCount; }
+        static constexpr size_t GetClassCount(void) { return kClassCount; }
+};
+
+#if __cplusplus >= 202002L
+
+//A string literal usable as a template argument.
+template <size_t N>
+struct FixedString {
+    constexpr FixedString(const char (&a_string)[N]) {
+        for(size_t i = 0; i < N; ++i) this->data[i] = a_string[i];
+    }
+
+    char data[N] = {};
+};
+
+template <FixedString kPattern>
+struct StaticPatternSource {
+    static constexpr const char* Get(void) { return kPattern.data; }
+    static constexpr size_t kLength = sizeof(kPattern.data) - 1;
+};
+
+template <FixedString kPattern, size_t kMaxStates = kStaticRegexMaxStates>
+using StaticRegex = BasicStaticRegex<StaticPatternSource<kPattern>, kMaxStates>;
+
+#else
+
+template <const char* kPattern>
+struct StaticPatternSource {
+    static constexpr const char* Get(void) { return kPattern; }
+    static constexpr size_t kLength = std::char_traits<char>::length(kPattern);
+};
+
+template <const char* kPattern, size_t kMaxStates = kStaticRegexMaxStates>
+using StaticRegex = BasicStaticRegex<StaticPatternSource<kPattern>, kMaxStates>;
+
+#endif
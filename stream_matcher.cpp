@@ -0,0 +1,251 @@
+/*
+ * Filename: stream_matcher.cpp
+ * Programmer: Abdurrahman Alyajouri
+ * Date: 10/17/2026
+ * Purpose: The purpose of this file is to implement the StreamMatcher class
+ *          declared in "stream_matcher.h".
+ */
+
+#include "stream_matcher.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using std::string;
+using std::string_view;
+using std::vector;
+
+//BEGINNING OF STREAMMATCHER CLASS IMPLEMENTATION
+
+StreamMatcher::StreamMatcher(const Regex& a_regex, MatchCallback a_callback)
+    : regex(a_regex), callback(std::move(a_callback)), epsilon_free(nullptr), step(0), position(0), fed(0),
+      backlog_head(0) {
+    if(a_regex.program->epsilon_free.IsBuilt()) this->epsilon_free = &a_regex.program->epsilon_free;
+    Reset();
+}
+
+void StreamMatcher::Feed(const char* data, size_t length) {
+    for(size_t i = 0; i < length; ++i) {
+        Step(data[i]);
+        if(this->backlog_head < this->backlog.size()) DrainBacklog();
+    }
+    this->fed += length;
+    return;
+}
+
+void StreamMatcher::Finish(void) {
+    //Whatever is still pending can't be extended anymore. Reporting it may
+    //queue bytes to scan again, which may find more matches.
+    while(this->best) {
+        Finalize();
+        DrainBacklog();
+    }
+    return;
+}
+
+void StreamMatcher::Reset(void) {
+    size_t state_count = this->epsilon_free ? this->epsilon_free->GetStateCount() : this->regex.program->nfa.GetStateCount();
+    this->marks.assign(state_count, 0);
+    this->step = 0;
+    this->fed = 0;
+    this->best.reset();
+    this->retained.clear();
+    this->backlog.clear();
+    this->backlog_head = 0;
+    this->last_end.reset();
+    Restart(0);
+    return;
+}
+
+size_t StreamMatcher::GetOffset(void) const {
+    return this->fed;
+}
+
+void StreamMatcher::Restart(size_t pos) {
+    this->position = pos;
+    this->current_threads.clear();
+    if(this->regex.program->nfa.IsEmpty()) return;
+    ++this->step;
+    AddStartThreads(this->current_threads, pos);
+    Check();
+    return;
+}
+
+void StreamMatcher::AddStartThreads(vector<Regex::Thread>& threads, size_t start) {
+    if(!this->epsilon_free) {
+        this->regex.AddThread(threads, this->marks, this->step, this->regex.program->nfa.GetStartState(),
+                              start, this->pending);
+        return;
+    }
+    for(std::uint32_t id : this->epsilon_free->GetStartStates()) {
+        if(this->marks[id] == this->step) continue;
+        this->marks[id] = this->step;
+        threads.push_back({id, start});
+    }
+    return;
+}
+
+bool StreamMatcher::IsAccepting(StateId state) const {
+    if(this->epsilon_free) return this->epsilon_free->GetState(state).acceptance;
+    return this->regex.program->nfa.GetState(state).acceptance;
+}
+
+void StreamMatcher::Step(char c) {
+    if(this->regex.program->nfa.IsEmpty()) return;
+
+    //Advance every thread over the byte, starting a new attempt behind
+    //them until something matched. Same as Regex::Find.
+    ++this->step;
+    this->next_threads.clear();
+    if(this->epsilon_free) {
+        for(const Regex::Thread& thread : this->current_threads) {
+            if(!this->epsilon_free->GetState(thread.state).Matches(c)) continue;
+            for(std::uint32_t next_state : this->epsilon_free->GetSuccessors(thread.state)) {
+                if(this->marks[next_state] == this->step) continue;
+                this->marks[next_state] = this->step;
+                this->next_threads.push_back({next_state, thread.start});
+            }
+        }
+    } else {
+        for(const Regex::Thread& thread : this->current_threads) {
+            const State& state = this->regex.program->nfa.GetState(thread.state);
+            if(state.Matches(c))
+                this->regex.AddThread(this->next_threads, this->marks, this->step,
+                                      state.symbol_transition, thread.start, this->pending);
+        }
+    }
+    if(!this->best) AddStartThreads(this->next_threads, this->position + 1);
+    this->current_threads.swap(this->next_threads);
+
+    //Bytes read past a match are needed again once it is reported.
+    if(this->best) this->retained += c;
+    ++this->position;
+
+    Check();
+    return;
+}
+
+void StreamMatcher::Check(void) {
+    for(size_t j = 0; j < this->current_threads.size(); ++j) {
+        const Regex::Thread& thread = this->current_threads[j];
+        if(!IsAccepting(thread.state)) continue;
+
+        //Prefer the leftmost, then the longest match.
+        if(!this->best || thread.start < this->best->begin ||
+           (thread.start == this->best->begin && this->position > this->best->end)) {
+            this->best = RegexMatch{thread.start, this->position};
+            this->retained.clear();
+        }
+
+        //Attempts that began later can't beat this match anymore.
+        size_t k = j + 1;
+        while(k < this->current_threads.size() && this->current_threads[k].start == thread.start) ++k;
+        this->current_threads.resize(k);
+        break;
+    }
+
+    if(this->best && this->current_threads.empty()) Finalize();
+    return;
+}
+
+void StreamMatcher::Finalize(void) {
+    RegexMatch match = *this->best;
+    this->best.reset();
+
+    //Like Regex::FindAll, skip empty matches that touch the previous match.
+    bool adjacent_empty = match.begin == match.end && this->last_end && *this->last_end == match.begin;
+    if(!adjacent_empty) {
+        this->callback(match);
+        this->last_end = match.end;
+    }
+
+    //Search again from the end of the match, or one byte later if it was
+    //empty, by scanning the retained bytes over.
+    string replay;
+    replay.swap(this->retained);
+    size_t restart = match.end;
+    if(match.begin == match.end) {
+        if(replay.empty()) {
+            //Only happens at the end of the stream, there is nothing left.
+            this->current_threads.clear();
+            this->position = match.end;
+            return;
+        }
+        replay.erase(0, 1);
+        ++restart;
+    }
+
+    this->backlog.erase(0, this->backlog_head);
+    this->backlog.insert(0, replay);
+    this->backlog_head = 0;
+    Restart(restart);
+    return;
+}
+
+void StreamMatcher::DrainBacklog(void) {
+    while(this->backlog_head < this->backlog.size()) {
+        char c = this->backlog[this->backlog_head++];
+        Step(c);
+    }
+    this->backlog.clear();
+    this->backlog_head = 0;
+    return;
+}
+
+//END OF STREAMMATCHER CLASS IMPLEMENTATION
+
+//Owns an open file and its mapping, and releases both when it goes out of
+//scope, even if a callback throws.
+struct FileMapping {
+    int fd = -1;
+    void* data = MAP_FAILED;
+    size_t length = 0;
+
+    ~FileMapping() {
+        if(this->data != MAP_FAILED) munmap(this->data, this->length);
+        if(this->fd >= 0) close(this->fd);
+    }
+};
+
+bool ScanFile(const Regex& a_regex, const string& path, StreamMatcher::MatchCallback callback) {
+    FileMapping file;
+    file.fd = open(path.c_str(), O_RDONLY);
+    if(file.fd < 0) return false;
+
+    struct stat info;
+    if(fstat(file.fd, &info) != 0) return false;
+
+    //Mapping an empty file fails, but there is nothing to map anyway.
+    string_view text;
+    if(info.st_size > 0) {
+        file.length = static_cast<size_t>(info.st_size);
+        file.data = mmap(nullptr, file.length, PROT_READ, MAP_PRIVATE, file.fd, 0);
+        if(file.data == MAP_FAILED) return false;
+        madvise(file.data, file.length, MADV_SEQUENTIAL);
+        text = string_view(static_cast<const char*>(file.data), file.length);
+    }
+
+    //Same loop as Regex::FindAll, reporting each match as it is found.
+    MatchContext context;
+    optional<size_t> last_end;
+    size_t pos = 0;
+    while(pos <= text.size()) {
+        optional<RegexMatch> match = a_regex.Find(text, context, pos);
+        if(!match) break;
+        if(match->begin == match->end && last_end && *last_end == match->begin) {
+            pos = match->begin + 1;
+            continue;
+        }
+        callback(*match);
+        last_end = match->end;
+        pos = match->end > match->begin ? match->end : match->end + 1;
+    }
+    return true;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+/*
+ * Filename: stream_matcher.h
+ * Programmer: Abdurrahman Alyajouri
+ * Date: 10/17/2026
+ * Purpose: The purpose of this file is to define the StreamMatcher class,
+ *          which searches input that arrives in arbitrary chunks for the
+ *          same leftmost-longest matches Regex::FindAll would report, with
+ *          offsets counted from the start of the stream.
+ */
+
+#include "regex.h"
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+using std::function;
+using std::optional;
+using std::size_t;
+using std::string;
+using std::vector;
+
+class StreamMatcher {
+    public:
+        //Called once per match, in order, with absolute stream offsets.
+        typedef function<void(const RegexMatch&)> MatchCallback;
+
+        //Ctor. "a_regex" must outlive the StreamMatcher.
+        StreamMatcher(const Regex& a_regex, MatchCallback a_callback);
+
+        //Scans the next "length" bytes of the stream. Only the bytes read
+        //past a match while looking for a longer one are kept between
+        //calls, the chunk itself is never copied.
+        void Feed(const char* data, size_t length);
+
+        //Signals the end of the stream, reporting any match that was still
+        //waiting to see if it could be extended.
+        void Finish(void);
+
+        //Forgets everything fed so far, to scan a new stream.
+        void Reset(void);
+
+        //Returns the number of bytes fed since the last reset.
+        size_t GetOffset(void) const;
+
+    private:
+        //Starts a new search at stream offset "pos".
+        void Restart(size_t pos);
+
+        //Adds a thread for every start state to "threads", as an attempt
+        //that began at "start". Steps "epsilon_free" if it is set and the
+        //TNFA otherwise, like the other functions below.
+        void AddStartThreads(vector<Regex::Thread>& threads, size_t start);
+
+        //Returns true if "state" is an accepting state.
+        bool IsAccepting(StateId state) const;
+
+        //Advances the search over byte "c", which is at offset "position".
+        void Step(char c);
+
+        //Looks for accepting threads at offset "position", then reports
+        //the best match once no thread can extend it anymore.
+        void Check(void);
+
+        //Reports the best match and restarts the search behind it. The
+        //bytes read past the match are queued in "backlog" to be scanned
+        //again.
+        void Finalize(void);
+
+        //Scans the bytes waiting in "backlog".
+        void DrainBacklog(void);
+
+        const Regex& regex;
+        MatchCallback callback;
+        const EpsilonFreeNFA* epsilon_free; //The regex's, or null if it isn't built.
+
+        vector<Regex::Thread> current_threads; //Threads at "position".
+        vector<Regex::Thread> next_threads; //Scratch for the next offset.
+        vector<size_t> marks; //Per state, the step it was last added in.
+        vector<StateId> pending; //Stack of the epsilon walks.
+        size_t step; //Number of thread lists built so far.
+
+        size_t position; //Offset the search is at.
+        size_t fed; //Number of bytes fed so far.
+
+        optional<RegexMatch> best; //Best match seen by the current search.
+        string retained; //Bytes scanned since "best" was last updated.
+        string backlog; //Bytes to scan again after a match was reported.
+        size_t backlog_head; //Next byte of "backlog" to scan.
+
+        optional<size_t> last_end; //End of the last match reported.
+};
+
+//Scans the file at "path" through a read-only memory mapping and reports
+//every match of "a_regex" to "callback". Since the whole file is mapped,
+//it is searched with Regex::Find like FindAll would, not fed to a
+//StreamMatcher. Returns false if the file could not be opened or mapped.
+bool ScanFile(const Regex& a_regex, const string& path, StreamMatcher::MatchCallback callback);
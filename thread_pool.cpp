@@ -0,0 +1,117 @@
+/*
+ * Filename: thread_pool.cpp
+ * Programmer: Abdurrahman Alyajouri
+ * Date: 10/17/2026
+ * Purpose: The purpose of this file is to implement the ThreadPool class
+ *          declared in "thread_pool.h".
+ */
+
+#include "thread_pool.h"
+#include <algorithm>
+#include <utility>
+
+//BEGINNING OF THREADPOOL CLASS IMPLEMENTATION
+
+ThreadPool::ThreadPool(size_t thread_count) : queued(0), stopping(false), next_queue(0) {
+    thread_count = std::max<size_t>(thread_count, 1);
+    for(size_t i = 0; i < thread_count; ++i) this->queues.push_back(std::make_unique<Queue>());
+    for(size_t i = 0; i < thread_count; ++i) this->workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> guard(this->sleep_lock);
+        this->stopping = true;
+    }
+    this->wake.notify_all();
+    for(std::thread& worker : this->workers) worker.join();
+}
+
+size_t ThreadPool::GetThreadCount(void) const {
+    return this->workers.size();
+}
+
+void ThreadPool::Run(size_t count, const std::function<void(size_t)>& task) {
+    if(count == 0) return;
+
+    Batch batch;
+    batch.task = &task;
+    batch.remaining = count;
+
+    //Deal the jobs out round robin, starting where the last batch stopped
+    //so small batches don't all land on the first worker.
+    size_t queue_count = this->queues.size();
+    size_t first = this->next_queue.fetch_add(count) % queue_count;
+    for(size_t q = 0; q < queue_count && q < count; ++q) {
+        Queue& queue = *this->queues[(first + q) % queue_count];
+        std::lock_guard<std::mutex> guard(queue.lock);
+        for(size_t i = q; i < count; i += queue_count) queue.jobs.push_back({&batch, i});
+    }
+    {
+        std::lock_guard<std::mutex> guard(this->sleep_lock);
+        this->queued += count;
+    }
+    this->wake.notify_all();
+
+    //Help until there is nothing left to take, then wait for the jobs
+    //still running elsewhere.
+    while(batch.remaining.load() != 0 && RunOne(first)) {}
+    {
+        std::unique_lock<std::mutex> guard(batch.lock);
+        batch.done.wait(guard, [&batch] { return batch.remaining.load() == 0; });
+    }
+
+    if(batch.error) std::rethrow_exception(batch.error);
+    return;
+}
+
+bool ThreadPool::RunOne(size_t own) {
+    size_t queue_count = this->queues.size();
+    for(size_t q = 0; q < queue_count; ++q) {
+        Queue& queue = *this->queues[(own + q) % queue_count];
+        Job job;
+        {
+            std::lock_guard<std::mutex> guard(queue.lock);
+            if(queue.jobs.empty()) continue;
+            if(q == 0) {
+                job = queue.jobs.back();
+                queue.jobs.pop_back();
+            } else {
+                job = queue.jobs.front();
+                queue.jobs.pop_front();
+            }
+        }
+        --this->queued;
+        Execute(job);
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::Execute(const Job& job) {
+    Batch& batch = *job.batch;
+    try {
+        (*batch.task)(job.index);
+    } catch(...) {
+        std::lock_guard<std::mutex> guard(batch.lock);
+        if(!batch.error) batch.error = std::current_exception();
+    }
+
+    //The batch lives on Run's stack, so it must not be touched once Run
+    //could see "remaining" reach zero outside of the lock.
+    std::lock_guard<std::mutex> guard(batch.lock);
+    if(--batch.remaining == 0) batch.done.notify_all();
+    return;
+}
+
+void ThreadPool::WorkerLoop(size_t own) {
+    while(true) {
+        if(RunOne(own)) continue;
+
+        std::unique_lock<std::mutex> guard(this->sleep_lock);
+        this->wake.wait(guard, [this] { return this->stopping || this->queued.load() != 0; });
+        if(this->stopping) return;
+    }
+}
+
+//END OF THREADPOOL CLASS IMPLEMENTATION
@@ -0,0 +1,86 @@
+#pragma once
+
+/*
+ * Filename: thread_pool.h
+ * Programmer: Abdurrahman Alyajouri
+ * Date: 10/17/2026
+ * Purpose: The purpose of this file is to define the ThreadPool class, a
+ *          fixed set of worker threads that run batches of tasks. Every
+ *          worker has its own queue and takes work from the back of it,
+ *          and a worker whose queue is empty steals from the front of the
+ *          others', so uneven tasks still keep every core busy.
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using std::size_t;
+
+class ThreadPool {
+    public:
+        //Ctor and dtor. The dtor waits for the workers to finish the tasks
+        //they are running.
+        explicit ThreadPool(size_t thread_count = std::thread::hardware_concurrency());
+        ~ThreadPool();
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        //Returns the number of worker threads.
+        size_t GetThreadCount(void) const;
+
+        //Runs "task(0)" through "task(count - 1)" on the workers, with the
+        //calling thread helping out, and returns once all of them are done.
+        //If a task throws, the first exception is rethrown here after the
+        //rest of the batch finished. Several threads may call Run at once.
+        void Run(size_t count, const std::function<void(size_t)>& task);
+
+    private:
+        //Tracks one call to Run.
+        struct Batch {
+            const std::function<void(size_t)>* task;
+            std::atomic<size_t> remaining;
+            std::mutex lock;
+            std::condition_variable done;
+            std::exception_ptr error;
+        };
+
+        //A task of a batch waiting in a queue.
+        struct Job {
+            Batch* batch;
+            size_t index;
+        };
+
+        struct Queue {
+            std::mutex lock;
+            std::deque<Job> jobs;
+        };
+
+        //Runs one job, from the back of queue "own" if it has one or else
+        //stolen from the front of another queue. Returns false if every
+        //queue was empty.
+        bool RunOne(size_t own);
+
+        //Runs "job" and marks it done in its batch.
+        void Execute(const Job& job);
+
+        void WorkerLoop(size_t own);
+
+        std::vector<std::unique_ptr<Queue>> queues; //One per worker.
+        std::vector<std::thread> workers;
+
+        //Idle workers sleep on "wake" until "queued" is nonzero.
+        std::mutex sleep_lock;
+        std::condition_variable wake;
+        std::atomic<size_t> queued;
+        bool stopping;
+
+        std::atomic<size_t> next_queue; //Where Run starts handing out jobs.
+};
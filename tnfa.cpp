@@ -1,348 +1,485 @@
 /*
- * Filename: tnfa.cpp 
+ * Filename: tnfa.cpp
  * Programmer: Abdurrahman Alyajouri
  * Date: 11/25/2025
  * Purpose: The purpose of this file is to implement the TNFA class declared
  *          in "tnfa.h".
  */
- 
+
 #include "tnfa.h"
-#include <unordered_map>
-#include <unordered_set>
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
 
-using std::unordered_map;
-using std::unordered_set;
+using std::string;
+using std::vector;
 
 //TODO: Review design, extend and or come up with better solutions for
 //      operators.
 
 //BEGINNING OF TNFA CLASS IMPLEMENTATION
 
-TNFA::TNFA() : start_state(nullptr), accept_state(nullptr) {}
+TNFA::TNFA() : start_state(kNoState), accept_state(kNoState) {}
+
+TNFA::TNFA(char c) : start_state(kNoState), accept_state(kNoState) {
+    this->start_state = AddState(false);
+    this->accept_state = AddState(true);
+    GetState(this->start_state).AddSymbolTransition(this->accept_state, c);
+}
 
-TNFA::TNFA(char c) : start_state(nullptr), accept_state(nullptr) {
-    this->start_state = new State(false);
-    this->accept_state = new State(true);
-    this->start_state->AddSymbolTransition(this->accept_state, c);
+TNFA::TNFA(const ByteSet& a_set) : start_state(kNoState), accept_state(kNoState) {
+    //One state per range of the set, each one taking its range straight to
+    //the accept state and falling through to the next one via an epsilon
+    //transition. An empty set leaves the accept state unreachable.
+    vector<pair<unsigned char, unsigned char>> ranges = a_set.GetRanges();
+    this->start_state = AddState(false);
+    this->accept_state = AddState(true);
+    StateId current = this->start_state;
+    for(size_t i = 0; i < ranges.size(); ++i) {
+        if(i > 0) {
+            StateId next_state = AddState(false);
+            GetState(current).AddEpsilonTransition(next_state);
+            current = next_state;
+        }
+        GetState(current).AddRangeTransition(this->accept_state, ranges[i].first, ranges[i].second);
+    }
 }
 
-TNFA::TNFA(State* the_start_state, State* the_accept_state) 
-    : start_state(the_start_state), accept_state(the_accept_state) {}
+TNFA::TNFA(const vector<string>& literals) : start_state(kNoState), accept_state(kNoState) {
+    //Shape the automaton like a trie of the literals, so literals with a
+    //common prefix share its states, instead of branching out to every
+    //literal from the start. Duplicates are dropped, and sorting makes
+    //every new child the last one of its parent.
+    vector<string> sorted(literals);
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    if(sorted.empty()) return;
+
+    struct Node {
+        vector<pair<unsigned char, size_t>> children; //By byte, sorted.
+        bool terminal = false; //A literal ends here.
+    };
+    vector<Node> nodes(1);
+    for(const string& literal : sorted) {
+        size_t node = 0;
+        for(char c : literal) {
+            unsigned char byte = static_cast<unsigned char>(c);
+            vector<pair<unsigned char, size_t>>& children = nodes[node].children;
+            if(children.empty() || children.back().first != byte) {
+                children.push_back({byte, nodes.size()});
+                nodes.emplace_back();
+            }
+            node = nodes[node].children.back().second;
+        }
+        nodes[node].terminal = true;
+    }
+
+    //Children come after their parents, so going backwards every child
+    //already has its entry state. A node lists its children as a chain of
+    //states linked by epsilon transitions, one per child, except that
+    //leaves with consecutive bytes share a single range transition. Leaves
+    //lead straight to the accept state, and a terminal node with children
+    //first branches off to it, so shorter literals come first.
+    this->accept_state = AddState(true);
+    vector<StateId> entries(nodes.size(), kNoState);
+    for(size_t node = nodes.size(); node-- > 0;) {
+        const vector<pair<unsigned char, size_t>>& children = nodes[node].children;
+        if(children.empty()) {
+            entries[node] = this->accept_state;
+            continue;
+        }
+
+        StateId previous = kNoState;
+        for(size_t i = 0; i < children.size();) {
+            unsigned char low = children[i].first;
+            StateId destination = entries[children[i].second];
+            size_t j = i + 1;
+            if(destination == this->accept_state) {
+                while(j < children.size() && entries[children[j].second] == this->accept_state &&
+                      children[j].first == children[j - 1].first + 1) ++j;
+            }
+
+            StateId link = AddState(false);
+            GetState(link).AddRangeTransition(destination, low, children[j - 1].first);
+            if(previous == kNoState) entries[node] = link;
+            else GetState(previous).AddEpsilonTransition(link);
+            previous = link;
+            i = j;
+        }
 
-TNFA::TNFA(const TNFA& a_tnfa) {
-    Copy(a_tnfa);
+        if(nodes[node].terminal) {
+            StateId branch = AddState(false);
+            GetState(branch).AddEpsilonTransition(this->accept_state);
+            GetState(branch).AddEpsilonTransition(entries[node]);
+            entries[node] = branch;
+        }
+    }
+    this->start_state = entries[0];
 }
 
-TNFA::~TNFA() {
-    Clear();
+TNFA::TNFA(TNFA&& a_tnfa) noexcept
+    : states(std::move(a_tnfa.states)), captures(std::move(a_tnfa.captures)), start_state(a_tnfa.start_state),
+      accept_state(a_tnfa.accept_state) {
+    a_tnfa.Clear();
 }
 
-TNFA& TNFA::operator=(const TNFA& a_tnfa) {
+TNFA& TNFA::operator=(TNFA&& a_tnfa) noexcept {
     if(this == &a_tnfa) return *this;
-    Clear();
-    Copy(a_tnfa);
+    this->states = std::move(a_tnfa.states);
+    this->captures = std::move(a_tnfa.captures);
+    this->start_state = a_tnfa.start_state;
+    this->accept_state = a_tnfa.accept_state;
+    a_tnfa.Clear();
     return *this;
 }
 
-void TNFA::SetStartState(State* a_start_state) {
+void TNFA::SetStartState(StateId a_start_state) {
     this->start_state = a_start_state;
     return;
 }
 
-void TNFA::SetAcceptState(State* an_accept_state) {
+void TNFA::SetAcceptState(StateId an_accept_state) {
     this->accept_state = an_accept_state;
     return;
 }
 
-State* TNFA::GetStartState(void) const {
+StateId TNFA::GetStartState(void) const {
     return this->start_state;
 }
 
-State* TNFA::GetAcceptState(void) const {
-    return this->start_state; 
+StateId TNFA::GetAcceptState(void) const {
+    return this->accept_state;
+}
+
+const State& TNFA::GetState(StateId id) const {
+    return this->states[id];
+}
+
+State& TNFA::GetState(StateId id) {
+    return this->states[id];
+}
+
+size_t TNFA::GetStateCount(void) const {
+    return this->states.size();
+}
+
+bool TNFA::IsEmpty(void) const {
+    return this->start_state == kNoState;
+}
+
+ByteClasses TNFA::GetByteClasses(void) const {
+    ByteClasses classes;
+    for(const State& state : this->states)
+        if(state.HasSymbolTransition()) classes.AddRange(state.low, state.high);
+    classes.Build();
+    return classes;
+}
+
+StateId TNFA::AddState(bool acceptance) {
+    this->states.emplace_back(acceptance);
+    return static_cast<StateId>(this->states.size() - 1);
 }
 
 TNFA& TNFA::operator+=(char c) {
-    if(!this->start_state) { //Signifies empty automaton.
-        this->start_state = new State(false);
-        this->accept_state = new State(true);
-        this->start_state->AddSymbolTransition(accept_state, c);
+    if(IsEmpty()) { //Signifies empty automaton.
+        *this = TNFA(c);
         return *this;
-    } 
-    
-    State* new_start_state = new State(false);
-    State* new_accept_state = new State(true);
-    
-    new_start_state->AddSymbolTransition(new_accept_state, c);
-    
-    this->accept_state->acceptance = false;
-    this->accept_state->AddEpsilonTransition(new_start_state);
-    
+    }
+
+    StateId new_start_state = AddState(false);
+    StateId new_accept_state = AddState(true);
+
+    GetState(new_start_state).AddSymbolTransition(new_accept_state, c);
+
+    GetState(this->accept_state).acceptance = false;
+    GetState(this->accept_state).AddEpsilonTransition(new_start_state);
+
     this->accept_state = new_accept_state;
-    
+
     return *this;
 }
 
 TNFA TNFA::operator+(char c) const {
-    State* rhs_start = new State(false);
-    State* rhs_accept = new State(true);
-    rhs_start->AddSymbolTransition(rhs_accept, c);
-    
-    //Check for empty lhs automaton, if empty, just return rhs automaton.
-    if(!this->start_state) return TNFA(rhs_start, rhs_accept);
-    
-    //Copy lhs automaton.
-    unordered_map<State*, State*> visited_state_map;
-    State* lhs_accept = nullptr;
-    State* lhs_start = CopyHelper(this->start_state, lhs_accept, visited_state_map);
-    
-    //Flip acceptance status for lhs.
-    lhs_accept->acceptance = false;
-    
-    //Add a transition from lhs accept to rhs start.
-    lhs_accept->AddEpsilonTransition(rhs_start);
-    
-    //Return new automaton.
-    return TNFA(lhs_start, rhs_accept);
+    TNFA result(*this);
+    result += c;
+    return result;
 }
 
 TNFA& TNFA::operator+=(const TNFA& a_tnfa) {
+    return *this += TNFA(a_tnfa);
+}
+
+TNFA& TNFA::operator+=(TNFA&& a_tnfa) {
     //If other a_tnfa is empty, just return.
-    if(!a_tnfa.start_state) return *this;
-    
-    //Copy a_tnfa to "rhs_start"
-    unordered_map<State*, State*> visited_state_map;
-    State* rhs_accept = nullptr;
-    State* rhs_start = CopyHelper(a_tnfa.start_state, rhs_accept, visited_state_map);
-    
+    if(a_tnfa.IsEmpty()) return *this;
+
+    //If the invoking tnfa is empty, just take over a_tnfa.
+    if(IsEmpty()) {
+        *this = std::move(a_tnfa);
+        return *this;
+    }
+
+    //Bring a_tnfa's states into the invoking state array.
+    StateId rhs_start = kNoState;
+    StateId rhs_accept = kNoState;
+    Splice(std::move(a_tnfa), rhs_start, rhs_accept);
+
     //Flip the acceptance level of the invoking accept state, add a transition
     //from the invoking accept state to the new start state, and set the
     //invoking accept state to the new accept state.
-    this->accept_state->acceptance = false;
-    this->accept_state->AddEpsilonTransition(rhs_start);
+    GetState(this->accept_state).acceptance = false;
+    GetState(this->accept_state).AddEpsilonTransition(rhs_start);
     this->accept_state = rhs_accept;
-    
+
     //Return modified automaton.
     return *this;
 }
 
 TNFA TNFA::operator+(const TNFA& a_tnfa) const {
-    unordered_map<State*, State*> visited_state_map;
-    
-    State* lhs_accept = nullptr;
-    State* lhs_start = CopyHelper(this->start_state, lhs_accept, visited_state_map);
-    
-    visited_state_map.clear();
-    
-    State* rhs_accept = nullptr;
-    State* rhs_start = CopyHelper(a_tnfa.start_state, rhs_accept, visited_state_map);
-    
-    lhs_accept->acceptance = false;
-    lhs_accept->AddEpsilonTransition(rhs_start);
-    
-    return TNFA(lhs_start, rhs_accept);
+    TNFA result(*this);
+    result += a_tnfa;
+    return result;
 }
 
 TNFA& TNFA::operator|=(const TNFA& a_tnfa) {
+    return *this |= TNFA(a_tnfa);
+}
+
+TNFA& TNFA::operator|=(TNFA&& a_tnfa) {
     //Can't alternate with an empty automaton so return as is.
-    if(!a_tnfa.start_state) return *this;
-    
+    if(a_tnfa.IsEmpty()) return *this;
+    if(IsEmpty()) {
+        *this = std::move(a_tnfa);
+        return *this;
+    }
+
+    //Bring a_tnfa's states into the invoking state array.
+    StateId rhs_start = kNoState;
+    StateId rhs_accept = kNoState;
+    Splice(std::move(a_tnfa), rhs_start, rhs_accept);
+
     //Setup alternation's start and accept state.
-    State* new_start_state = new State(false);
-    State* new_accept_state = new State(true);
-    
-    //Copy a_tnfa.
-    unordered_map<State*, State*> visited_state_map;
-    State* rhs_accept = nullptr;
-    State* rhs_start = CopyHelper(a_tnfa.start_state, rhs_accept, visited_state_map);
-    
+    StateId new_start_state = AddState(false);
+    StateId new_accept_state = AddState(true);
+
     //Transition from new start state to both invoking start state and second start state.
-    new_start_state->AddEpsilonTransition(this->start_state);
-    new_start_state->AddEpsilonTransition(rhs_start);
-    
+    GetState(new_start_state).AddEpsilonTransition(this->start_state);
+    GetState(new_start_state).AddEpsilonTransition(rhs_start);
+
     //Flip acceptance status of invoking accept state and rhs accept state.
-    this->accept_state->acceptance = false;
-    rhs_accept->acceptance = false;
-    
-    //Transition from invoking accept state and second accept state to 
+    GetState(this->accept_state).acceptance = false;
+    GetState(rhs_accept).acceptance = false;
+
+    //Transition from invoking accept state and second accept state to
     //the new accept_state.
-    this->accept_state->AddEpsilonTransition(new_accept_state);
-    rhs_accept->AddEpsilonTransition(new_accept_state);
-    
+    GetState(this->accept_state).AddEpsilonTransition(new_accept_state);
+    GetState(rhs_accept).AddEpsilonTransition(new_accept_state);
+
     //Change start and accept states to the new start and accept
     //states.
     this->start_state = new_start_state;
     this->accept_state = new_accept_state;
-    
+
     return *this; //Return modified automaton.
 }
 
 TNFA TNFA::operator|(const TNFA& a_tnfa) const {
-    //Prep states for new alternated automaton.
-    State* new_start_state = new State(false);
-    State* new_accept_state = new State(true);
-    
-    unordered_map<State*, State*> visited_state_map; //Track states during copy.
-    
-    //Copy first automaton (the invoking one, left hand side).
-    State* lhs_accept = nullptr;
-    State* lhs_start = CopyHelper(this->start_state, lhs_accept, visited_state_map);
-    
-    //Reset state map for copying the second automaton (Technically unnecessary).
-    visited_state_map.clear();
-    
-    //Copy second automaton (right hand side).
-    State* rhs_accept = nullptr;
-    State* rhs_start = CopyHelper(a_tnfa.start_state, rhs_accept, visited_state_map);
-    
-    //Flip acceptance status' of each accept state in preparation for the new 
-    //alternated automaton.
-    lhs_accept->acceptance = false;
-    rhs_accept->acceptance = false;
-    
-    //Transition from new start state to lhs and rhs start states
-    new_start_state->AddEpsilonTransition(lhs_start);
-    new_start_state->AddEpsilonTransition(rhs_start);
-    
-    //Transition from lhs and rhs accept states to new accept state.
-    lhs_accept->AddEpsilonTransition(new_accept_state);
-    rhs_accept->AddEpsilonTransition(new_accept_state);
-    
-    //Return the final automaton.
-    return TNFA(new_start_state, new_accept_state);
+    TNFA result(*this);
+    result |= a_tnfa;
+    return result;
+}
+
+StateId TNFA::AddBranch(const TNFA& a_tnfa) {
+    if(a_tnfa.IsEmpty()) return kNoState;
+    if(IsEmpty()) {
+        *this = a_tnfa;
+        return this->accept_state;
+    }
+
+    //Copy a_tnfa's states behind the invoking ones, leaving those in place.
+    StateId offset = Append(a_tnfa);
+
+    //Branch from a new start state to the old one and a_tnfa's.
+    StateId new_start_state = AddState(false);
+    GetState(new_start_state).AddEpsilonTransition(this->start_state);
+    GetState(new_start_state).AddEpsilonTransition(a_tnfa.start_state + offset);
+    this->start_state = new_start_state;
+
+    return a_tnfa.accept_state + offset;
 }
 
 TNFA& TNFA::ApplyKleeneClosure(void) {
     //Can't apply kleene closure on an empty automaton so return as is.
-    if(!this->start_state) return *this;
-    
+    if(IsEmpty()) return *this;
+
     //Create kleene closure's start and accept states.
-    State* new_start_state = new State(false);
-    State* new_accept_state = new State(true);
-    
+    StateId new_start_state = AddState(false);
+    StateId new_accept_state = AddState(true);
+
     //Add transitions from new start to the invoking start and new accept.
-    new_start_state->AddEpsilonTransition(this->start_state);
-    new_start_state->AddEpsilonTransition(new_accept_state);
-    
+    GetState(new_start_state).AddEpsilonTransition(this->start_state);
+    GetState(new_start_state).AddEpsilonTransition(new_accept_state);
+
     //Add transitions from invoking accept state to invoking start and
     //new accept state.
-    this->accept_state->AddEpsilonTransition(this->start_state);
-    this->accept_state->AddEpsilonTransition(new_accept_state);
-    
+    GetState(this->accept_state).AddEpsilonTransition(this->start_state);
+    GetState(this->accept_state).AddEpsilonTransition(new_accept_state);
+
     //Flip acceptance level
-    this->accept_state->acceptance = false;
-    
+    GetState(this->accept_state).acceptance = false;
+
     //Set invoking start and accept states to the new start and accept states.
     this->start_state = new_start_state;
     this->accept_state = new_accept_state;
-    
+
     //Return modified automaton.
     return *this;
 }
 
-void TNFA::Copy(const TNFA& a_tnfa) {
-    //If other "a_tnfa" is empty, clear the invoking tnfa.
-    if(!a_tnfa.start_state) {
+TNFA& TNFA::ApplyOneOrMore(void) {
+    //Can't repeat an empty automaton so return as is.
+    if(IsEmpty()) return *this;
+
+    //Loop from the invoking accept state back to the invoking start state,
+    //or leave through a new accept state.
+    StateId new_accept_state = AddState(true);
+    GetState(this->accept_state).AddEpsilonTransition(this->start_state);
+    GetState(this->accept_state).AddEpsilonTransition(new_accept_state);
+    GetState(this->accept_state).acceptance = false;
+    this->accept_state = new_accept_state;
+    return *this;
+}
+
+TNFA& TNFA::ApplyOptional(void) {
+    //Can't make an empty automaton optional so return as is.
+    if(IsEmpty()) return *this;
+
+    //A new start state either enters the invoking TNFA or skips straight
+    //to its accept state.
+    StateId new_start_state = AddState(false);
+    GetState(new_start_state).AddEpsilonTransition(this->start_state);
+    GetState(new_start_state).AddEpsilonTransition(this->accept_state);
+    this->start_state = new_start_state;
+    return *this;
+}
+
+TNFA& TNFA::ApplyRepetition(std::uint32_t min, std::uint32_t max) {
+    if(IsEmpty()) return *this;
+
+    //Zero repetitions only match the empty string.
+    if(max == 0) {
         Clear();
-        return;
+        this->start_state = this->accept_state = AddState(true);
+        return *this;
     }
-    
-    //Copy "a_tnfa" to "second_start"
-    unordered_map<State*, State*> visited_state_map;
-    State* new_accept = nullptr;
-    State* new_start = CopyHelper(a_tnfa.start_state, new_accept, visited_state_map);
-    this->start_state = new_start;
-    this->accept_state = new_accept;
-    return;
-}
 
-State* TNFA::CopyHelper(State* source_state, State*& accept_state, unordered_map<State*, State*>& visited_state_map) const {
-    //Will store the copied state from source_state
-    State* copy_state = new State(source_state->acceptance); 
-    
-    //Make sure to properly set the new accept state.
-    if(copy_state->acceptance) accept_state = copy_state;
-    
-    //Pair up the source state to the corresponding copied state, for easy
-    //retrieval in the future.
-    visited_state_map.insert({source_state, copy_state});
-    
-    //Now visit neighboring states
-    for(const auto& [symbol, next_states] : source_state->symbol_transitions) {
-        for(State* next_state : next_states) {
-            if(visited_state_map.count(next_state) == 0) {
-                copy_state->symbol_transitions[symbol].push_back(CopyHelper(next_state, accept_state, visited_state_map));    
-            } else {
-                copy_state->symbol_transitions[symbol].push_back(visited_state_map.at(next_state));
-            }
+    TNFA operand(std::move(*this));
+    Clear();
+
+    //The part after the required copies: x* if unbounded, otherwise the
+    //nested optional copies (x(x(x)?)?)?. With at least one required copy
+    //and no bound, the last required copy becomes x+ instead.
+    TNFA rest;
+    if(max == kUnbounded) {
+        if(min == 0) rest = KleeneClosure(operand);
+    } else {
+        for(std::uint32_t i = min; i < max; ++i) {
+            TNFA optional_copy(operand);
+            optional_copy += std::move(rest);
+            rest = std::move(optional_copy.ApplyOptional());
         }
     }
-    
-    for(State* next_state : source_state->epsilon_transitions) {
-        if(visited_state_map.count(next_state) == 0) {
-            copy_state->epsilon_transitions.push_back(CopyHelper(next_state, accept_state, visited_state_map));
-        } else {
-            copy_state->epsilon_transitions.push_back(visited_state_map.at(next_state));
-        }
+
+    for(std::uint32_t i = 0; i < min; ++i) {
+        TNFA copy(operand);
+        if(max == kUnbounded && i + 1 == min) copy.ApplyOneOrMore();
+        *this += std::move(copy);
     }
-    
-    //Connect up the TNFA graph as the recursion stack closes.
-    return copy_state;
+    *this += std::move(rest);
+    return *this;
+}
+
+TNFA& TNFA::ApplyCapture(std::uint32_t group) {
+    //Can't capture an empty automaton so return as is.
+    if(IsEmpty()) return *this;
+
+    StateId new_start_state = AddState(false);
+    StateId new_accept_state = AddState(true);
+
+    //Pass through the new start state on the way in and the new accept
+    //state on the way out.
+    GetState(new_start_state).AddEpsilonTransition(this->start_state);
+    GetState(this->accept_state).AddEpsilonTransition(new_accept_state);
+    GetState(this->accept_state).acceptance = false;
+
+    this->captures.push_back({new_start_state, 2 * group});
+    this->captures.push_back({new_accept_state, 2 * group + 1});
+
+    this->start_state = new_start_state;
+    this->accept_state = new_accept_state;
+    return *this;
+}
+
+const vector<CaptureMarker>& TNFA::GetCaptureMarkers(void) const {
+    return this->captures;
 }
 
 void TNFA::Clear(void) {
-    if(!this->start_state) return;
-    unordered_set<State*> visited;
-    ClearHelper(this->start_state, visited);
-}
-
-void TNFA::ClearHelper(State* current_state, unordered_set<State*>& visited) {
-    visited.insert(current_state); //Mark visited.
-    
-    //Traverse transitions.
-    for(const auto& [symbol, next_states] : current_state->symbol_transitions) {
-        for(State* next_state : next_states) {
-            if(visited.count(next_state) == 0) {
-                ClearHelper(next_state, visited);
-            }
-        }
+    this->states.clear();
+    this->captures.clear();
+    this->start_state = kNoState;
+    this->accept_state = kNoState;
+    return;
+}
+
+StateId TNFA::Append(const TNFA& a_tnfa) {
+    //Inserting a vector into itself is not allowed, so append a copy.
+    if(this == &a_tnfa) return Append(TNFA(a_tnfa));
+
+    StateId offset = static_cast<StateId>(this->states.size());
+    this->states.insert(this->states.end(), a_tnfa.states.begin(), a_tnfa.states.end());
+
+    //Shift the copied transitions so they point into the copied states.
+    for(size_t i = offset; i < this->states.size(); ++i) {
+        State& state = this->states[i];
+        if(state.HasSymbolTransition()) state.symbol_transition += offset;
+        for(int j = 0; j < state.epsilon_count; ++j)
+            state.epsilon_transitions[j] += offset;
     }
-    
-    for(State* next_state : current_state->epsilon_transitions) {
-        if(visited.count(next_state) == 0) {
-            ClearHelper(next_state, visited);
-        }
+    for(const CaptureMarker& marker : a_tnfa.captures)
+        this->captures.push_back({marker.state + offset, marker.slot});
+
+    return offset;
+}
+
+void TNFA::Splice(TNFA&& a_tnfa, StateId& rhs_start, StateId& rhs_accept) {
+    if(this->states.size() >= a_tnfa.states.size()) {
+        //Copy a_tnfa's states behind the invoking ones.
+        StateId offset = Append(a_tnfa);
+        rhs_start = a_tnfa.start_state + offset;
+        rhs_accept = a_tnfa.accept_state + offset;
+    } else {
+        //Copy the invoking states behind a_tnfa's and take over its array.
+        StateId offset = a_tnfa.Append(*this);
+        StateId lhs_start = this->start_state + offset;
+        StateId lhs_accept = this->accept_state + offset;
+        rhs_start = a_tnfa.start_state;
+        rhs_accept = a_tnfa.accept_state;
+        this->states = std::move(a_tnfa.states);
+        this->captures = std::move(a_tnfa.captures);
+        this->start_state = lhs_start;
+        this->accept_state = lhs_accept;
     }
-    
-    if(current_state) delete current_state;
+
+    a_tnfa.Clear();
     return;
 }
 
 //END OF TNFA CLASS IMPLEMENTATION
 
 TNFA KleeneClosure(const TNFA& a_tnfa) {
-    //Setup start and accept states for the new kleen automaton.
-    State* new_start_state = new State(false);
-    State* new_accept_state = new State(true);
-    
-    //Track copied states.
-    unordered_map<State*, State*> visited_state_map;
-    State* accept_copy = nullptr;
-    State* start_copy = a_tnfa.CopyHelper(a_tnfa.start_state, accept_copy, visited_state_map);
-    
-    //Add transition to start copy and new accept state.
-    new_start_state->AddEpsilonTransition(start_copy);
-    new_start_state->AddEpsilonTransition(new_accept_state);
-    
-    //Transition from accept copy to start copy and new accept.
-    accept_copy->AddEpsilonTransition(start_copy);
-    accept_copy->AddEpsilonTransition(new_accept_state);
-    
-    //Flip acceptance status of accept copy.
-    accept_copy->acceptance = false;
-    
-    //Return the new automaton.
-    return TNFA(new_start_state, new_accept_state);
-}
-
-    
+    TNFA result(a_tnfa);
+    result.ApplyKleeneClosure();
+    return result;
+}
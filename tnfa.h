@@ -1,78 +1,146 @@
 #pragma once
 
 /*
- * Filename: nfa.h 
+ * Filename: nfa.h
  * Programmer: Abdurrahman Alyajouri
  * Date: 11/25/2025
  * Purpose: The purpose of this file is to define the TNFA class, meant
  *          to represent specifically a thompson constructed non
- *          deterministic finite state automaton. I wanted to practice
- *          writing custom data structures and proper copying and deleting,
- *          so I opted to not use smart pointers.
+ *          deterministic finite state automaton. All states of a TNFA are
+ *          stored in a single contiguous array that the TNFA owns, and
+ *          transitions are indices into that array, so copying or freeing
+ *          an automaton never has to walk its graph.
  */
- 
+
+#include "byte_class.h"
 #include "state.h"
-#include <unordered_map>
-#include <unordered_set>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using std::size_t;
+using std::string;
+using std::vector;
 
-using std::unordered_map;
-using std::unordered_set;
- 
-//TODO: Maybe explicitly store the entire state graph rather than indirectly
-//      through state object transition lists?
+//Marks a state that records the current input offset in capture slot
+//"slot" when a match passes through it. Group g uses slots 2g and 2g + 1
+//for where it begins and ends.
+struct CaptureMarker {
+    StateId state;
+    std::uint32_t slot;
+};
 
 class TNFA {
     public:
-        //Default ctor, overloaded ctors, dtor, copy ctor and overloaded 
-        //assignment otor.
+        //Default ctor, overloaded ctor, copy and move ctors and assignment
+        //otors. Moving a TNFA never touches its states.
         TNFA();
         TNFA(char c); //Recognize a literal symbol.
-        TNFA(State* the_start_state, State* the_accept_state);
-        TNFA(const TNFA& a_tnfa);
-        ~TNFA();
-        TNFA& operator=(const TNFA& a_tnfa);
-        
+        TNFA(const ByteSet& a_set); //Recognize any byte of a set.
+        TNFA(const vector<string>& literals); //Recognize any of a set of strings.
+        TNFA(const TNFA& a_tnfa) = default;
+        TNFA(TNFA&& a_tnfa) noexcept;
+        TNFA& operator=(const TNFA& a_tnfa) = default;
+        TNFA& operator=(TNFA&& a_tnfa) noexcept;
+
         //Setters. TODO: Might remove.
-        void SetStartState(State* a_start_state); 
-        void SetAcceptState(State* an_accept_state);
-        
+        void SetStartState(StateId a_start_state);
+        void SetAcceptState(StateId an_accept_state);
+
         //Getters.
-        State* GetStartState(void) const;
-        State* GetAcceptState(void) const;
-        
+        StateId GetStartState(void) const;
+        StateId GetAcceptState(void) const;
+
+        //Access to the state array. "GetState" expects a valid index.
+        const State& GetState(StateId id) const;
+        State& GetState(StateId id);
+        size_t GetStateCount(void) const;
+
+        //Returns true if the automaton has no states.
+        bool IsEmpty(void) const;
+
+        //Partitions the input bytes into classes that none of the symbol
+        //transitions tell apart.
+        ByteClasses GetByteClasses(void) const;
+
+        //Allocates a new state at the end of the state array and returns
+        //its index.
+        StateId AddState(bool acceptance);
+
         //Overloaded addition and compound assignment for TNFA
         //concatenation with a literal character.
         TNFA& operator+=(char c);
         TNFA operator+(char c) const;
-        
+
         //Overloaded addition and compound assignment for TNFA
-        //concatenation.
+        //concatenation. The rvalue overload splices "a_tnfa"'s states in
+        //instead of copying them when it is the larger operand.
         TNFA& operator+=(const TNFA& a_tnfa);
+        TNFA& operator+=(TNFA&& a_tnfa);
         TNFA operator+(const TNFA& a_tnfa) const;
-        
+
         //Overloaded bitwise OR and compound assignment for TNFA
-        //alternation.
+        //alternation. The rvalue overload splices like the one above.
         TNFA& operator|=(const TNFA& a_tnfa);
+        TNFA& operator|=(TNFA&& a_tnfa);
         TNFA operator|(const TNFA& a_tnfa) const;
-        
+
         //TODO: support alternation against literal characters as well.
-        
+
+        //Adds "a_tnfa" as an alternative to the invoking TNFA without
+        //joining their accept states, so that it can still be told which
+        //alternative matched. The states of the invoking TNFA keep their
+        //indices and its accept state keeps referring to the first
+        //alternative. Returns the index of "a_tnfa"'s accept state.
+        StateId AddBranch(const TNFA& a_tnfa);
+
         //Apply a kleene closure to a TNFA.
         TNFA& ApplyKleeneClosure(void);
         friend TNFA KleeneClosure(const TNFA& a_tnfa);
-        
+
+        //Apply one or more ('+') and zero or one ('?') repetition to a TNFA.
+        TNFA& ApplyOneOrMore(void);
+        TNFA& ApplyOptional(void);
+
+        //Marks a repetition without an upper bound.
+        static constexpr std::uint32_t kUnbounded = 0xFFFFFFFF;
+
+        //Repeats a TNFA between "min" and "max" times, "max" may be
+        //kUnbounded. Copies of the TNFA are appended one after the other,
+        //so the result has about max(min + 1, max) times as many states,
+        //and building it takes time linear in that. Optional copies are
+        //nested, x{1,3} being x(x(x)?)?, so no state fans out to all of
+        //them.
+        TNFA& ApplyRepetition(std::uint32_t min, std::uint32_t max);
+
+        //Wraps the TNFA in capture group "group", with a new start and
+        //accept state that record where the group begins and ends.
+        TNFA& ApplyCapture(std::uint32_t group);
+
+        //Returns the capture markers of every capture group applied so far.
+        //Several states may share a slot, e.g. when a group was copied.
+        const vector<CaptureMarker>& GetCaptureMarkers(void) const;
+
         void Clear(void);
-        
+
     private:
-        //Deep copy from another TNFA. "Copy" takes in a TNFA object to copy,
-        //"CopyHelper" takes in a source state to copy from and a set of
-        //"visited" states, and returns the new copied State*. 
-        void Copy(const TNFA& a_tnfa);
-        State* CopyHelper(State* source_state, State*& accept_state, unordered_map<State*, State*>& visited_state_map) const;
-        
-        //Recursively delete all states.
-        void ClearHelper(State* current_state, unordered_set<State*>& visited);
-    
-        State* start_state; //The starting state of this TNFA.
-        State* accept_state; //The accepting state of this TNFA.
+        //Appends copies of all of "a_tnfa"'s states to the state array,
+        //shifting their transitions accordingly. Returns the offset the
+        //copied states start at.
+        StateId Append(const TNFA& a_tnfa);
+
+        //Moves the states of "a_tnfa" and the invoking TNFA into a single
+        //state array, copying the smaller of the two behind the larger one
+        //so that building an automaton copies each state O(log n) times.
+        //Afterwards the invoking TNFA owns every state, its start and accept
+        //states are remapped, "rhs_start" and "rhs_accept" hold "a_tnfa"'s
+        //remapped start and accept states, and "a_tnfa" is empty.
+        void Splice(TNFA&& a_tnfa, StateId& rhs_start, StateId& rhs_accept);
+
+        vector<State> states; //Every state of this TNFA.
+        vector<CaptureMarker> captures; //Capture markers, in no particular order.
+
+        StateId start_state; //The starting state of this TNFA.
+        StateId accept_state; //The accepting state of this TNFA.
 };
@@ -0,0 +1,301 @@
+/*
+ * Filename: benchmark.cpp
+ * Programmer: Abdurrahman Alyajouri
+ * Date: 10/17/2026
+ * Purpose: The purpose of this file is to measure how long patterns take to
+ *          compile and how fast they match, for each engine in the repo and
+ *          for std::regex as a baseline. It covers log lines, a large
+ *          alternation and patterns that are pathological for backtracking
+ *          engines. Results are written as JSON or CSV so they can be
+ *          compared between versions.
+ *
+ *          Usage: benchmark [--format json|csv] [--filter <substring>]
+ *                           [--seconds <minimum time per measurement>]
+ */
+
+#include "../dfa.h"
+#include "../dfa_layout.h"
+#include "../regex.h"
+#include "../regex_cache.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <regex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using std::cerr;
+using std::cout;
+using std::function;
+using std::string;
+using std::vector;
+
+typedef std::chrono::steady_clock Clock;
+
+//What a case does with its inputs. kMatch checks every input as a whole,
+//kFind finds every match in every input.
+enum class Mode { kMatch, kFind };
+
+struct Case {
+    string name;
+    string pattern;
+    Mode mode;
+    vector<string> inputs;
+
+    //std::regex backtracks, so on some patterns it takes exponential time
+    //or runs out of stack. Those cases skip it.
+    bool run_std_regex;
+};
+
+struct Result {
+    string case_name;
+    string engine;
+    bool skipped;
+    string reason; //Why it was skipped.
+    double compile_us; //Microseconds per compile.
+    double mb_per_s; //Input megabytes scanned per second.
+    double matches_per_s; //Successful matches per second.
+    size_t matches; //Matches in one pass over the inputs.
+};
+
+//Returns the seconds since "start".
+static double Elapsed(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+//Runs "pass" until at least "min_seconds" went by. Returns the seconds
+//per pass.
+static double TimePasses(const function<void(void)>& pass, double min_seconds) {
+    size_t passes = 0;
+    Clock::time_point start = Clock::now();
+    do {
+        pass();
+        ++passes;
+    } while(Elapsed(start) < min_seconds);
+    return Elapsed(start) / passes;
+}
+
+//Returns the microseconds one call to "compile" takes.
+static double TimeCompile(const function<void(void)>& compile, double min_seconds) {
+    return TimePasses(compile, min_seconds / 4) * 1e6;
+}
+
+//Fills in the throughput of "result" from one pass over "a_case".
+static void SetThroughput(Result& result, const Case& a_case, double seconds_per_pass) {
+    size_t bytes = 0;
+    for(const string& input : a_case.inputs) bytes += input.size();
+    result.mb_per_s = bytes / seconds_per_pass / (1024.0 * 1024.0);
+    result.matches_per_s = result.matches / seconds_per_pass;
+}
+
+static Result Skipped(const Case& a_case, const string& engine, const string& reason) {
+    return Result{a_case.name, engine, true, reason, 0, 0, 0, 0};
+}
+
+static Result RunRegex(const Case& a_case, double min_seconds) {
+    Result result{a_case.name, "regex", false, "", 0, 0, 0, 0};
+    result.compile_us = TimeCompile([&] { Regex re(a_case.pattern); }, min_seconds);
+
+    Regex re(a_case.pattern);
+    auto pass = [&] {
+        result.matches = 0;
+        for(const string& input : a_case.inputs) {
+            if(a_case.mode == Mode::kMatch) result.matches += re.Match(input);
+            else result.matches += re.FindAll(input).size();
+        }
+    };
+    SetThroughput(result, a_case, TimePasses(pass, min_seconds));
+    return result;
+}
+
+static Result RunDFA(const Case& a_case, double min_seconds) {
+    if(a_case.mode != Mode::kMatch) return Skipped(a_case, "dfa", "DFA only matches whole inputs");
+
+    Result result{a_case.name, "dfa", false, "", 0, 0, 0, 0};
+    try {
+        result.compile_us = TimeCompile([&] { DFA dfa((Regex(a_case.pattern))); }, min_seconds);
+    } catch(const std::length_error&) {
+        return Skipped(a_case, "dfa", "too many states");
+    }
+
+    DFA dfa((Regex(a_case.pattern)));
+    auto pass = [&] {
+        result.matches = 0;
+        for(const string& input : a_case.inputs) result.matches += dfa.Match(input);
+    };
+    SetThroughput(result, a_case, TimePasses(pass, min_seconds));
+    return result;
+}
+
+static Result RunDFALayout(const Case& a_case, double min_seconds) {
+    if(a_case.mode != Mode::kMatch) return Skipped(a_case, "dfa_layout", "DFA only matches whole inputs");
+
+    //The layout is ordered by a profile of the first few inputs, which is
+    //part of what compiling it costs.
+    Result result{a_case.name, "dfa_layout", false, "", 0, 0, 0, 0};
+    size_t samples = std::min<size_t>(a_case.inputs.size(), 64);
+    auto build = [&](const DFA& dfa) {
+        DFAProfile profile(dfa);
+        for(size_t i = 0; i < samples; ++i) profile.Record(a_case.inputs[i]);
+        return DFALayout(dfa, profile);
+    };
+    try {
+        result.compile_us = TimeCompile([&] { DFA dfa((Regex(a_case.pattern))); build(dfa); }, min_seconds);
+    } catch(const std::length_error&) {
+        return Skipped(a_case, "dfa_layout", "too many states");
+    }
+
+    DFA dfa((Regex(a_case.pattern)));
+    DFALayout layout = build(dfa);
+    auto pass = [&] {
+        result.matches = 0;
+        for(const string& input : a_case.inputs) result.matches += layout.Match(input);
+    };
+    SetThroughput(result, a_case, TimePasses(pass, min_seconds));
+    return result;
+}
+
+static Result RunStdRegex(const Case& a_case, double min_seconds) {
+    if(!a_case.run_std_regex) return Skipped(a_case, "std::regex", "backtracks exponentially or overflows the stack");
+
+    Result result{a_case.name, "std::regex", false, "", 0, 0, 0, 0};
+    result.compile_us = TimeCompile([&] { std::regex re(a_case.pattern); }, min_seconds);
+
+    std::regex re(a_case.pattern);
+    auto pass = [&] {
+        result.matches = 0;
+        for(const string& input : a_case.inputs) {
+            if(a_case.mode == Mode::kMatch) {
+                result.matches += std::regex_match(input, re);
+            } else {
+                auto begin = std::sregex_iterator(input.begin(), input.end(), re);
+                result.matches += std::distance(begin, std::sregex_iterator());
+            }
+        }
+    };
+    SetThroughput(result, a_case, TimePasses(pass, min_seconds));
+    return result;
+}
+
+//Builds the cases. Inputs are generated from a fixed seed so every run
+//sees the same bytes.
+static vector<Case> MakeCases(void) {
+    std::mt19937 rng(2024);
+    auto pick = [&rng](const vector<string>& words) { return words[rng() % words.size()]; };
+    vector<string> levels = {"INFO", "INFO", "INFO", "WARN", "ERROR", "DEBUG"};
+    vector<string> modules = {"auth", "db", "http", "cache", "scheduler"};
+    vector<string> words = {"request", "served", "user", "timeout", "connection", "closed", "retry",
+                            "query", "slow", "token", "expired", "queue", "full", "ok"};
+
+    //Log lines like "2024-11-28 13:05:59 WARN db: query slow retry".
+    vector<string> lines;
+    for(int i = 0; i < 20000; ++i) {
+        char stamp[32];
+        std::snprintf(stamp, sizeof(stamp), "2024-%02d-%02d %02d:%02d:%02d ", 1 + i % 12, 1 + i % 28,
+                      i % 24, i % 60, (i * 7) % 60);
+        string line = stamp + pick(levels) + " " + pick(modules) + ":";
+        for(int w = 0, count = 3 + rng() % 8; w < count; ++w) line += " " + pick(words);
+        lines.push_back(line);
+    }
+    string log;
+    for(const string& line : lines) log += line + "\n";
+
+    //A large alternation of words, searched for in text made of them and
+    //other words.
+    vector<string> keywords;
+    for(int i = 0; i < 500; ++i) {
+        string word;
+        for(int j = 0, length = 4 + rng() % 6; j < length; ++j) word += static_cast<char>('a' + rng() % 26);
+        keywords.push_back(word);
+    }
+    string alternation = "(";
+    for(size_t i = 0; i < keywords.size(); ++i) alternation += (i ? "|" : "") + keywords[i];
+    alternation += ")";
+    string text;
+    while(text.size() < (1 << 20)) text += (rng() % 4 ? pick(words) : pick(keywords)) + " ";
+
+    string many_a(4096, 'a');
+
+    vector<Case> cases;
+    cases.push_back({"log_match",
+                     "\\d\\d\\d\\d-\\d\\d-\\d\\d \\d\\d:\\d\\d:\\d\\d (WARN|ERROR) [a-z]*:[a-z ]*",
+                     Mode::kMatch, lines, true});
+    cases.push_back({"log_find_error", "ERROR [a-z]*: [a-z]*", Mode::kFind, {log}, true});
+    cases.push_back({"log_find_rare", "\\d\\d:\\d\\d:\\d\\d FATAL [a-z]*:", Mode::kFind, {log}, true});
+    cases.push_back({"hello_world", "((Hello)|(Hi)) Worlds*", Mode::kMatch,
+                     {"Hello World", "Hi Worldssss", "Hello Worl", "Hey World"}, true});
+    cases.push_back({"nested_star_4k", "(a*)*b", Mode::kMatch, {many_a}, false});
+    cases.push_back({"alternation_star_4k", "(a|aa)*", Mode::kMatch, {many_a}, false});
+    cases.push_back({"alternation_500_find", alternation, Mode::kFind, {text}, true});
+    return cases;
+}
+
+static void WriteJSON(const vector<Result>& results) {
+    cout << "[\n";
+    for(size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        cout << "  {\"case\": \"" << r.case_name << "\", \"engine\": \"" << r.engine << "\", ";
+        if(r.skipped) {
+            cout << "\"skipped\": true, \"reason\": \"" << r.reason << "\"}";
+        } else {
+            cout << "\"skipped\": false, \"compile_us\": " << r.compile_us << ", \"mb_per_s\": " << r.mb_per_s
+                 << ", \"matches_per_s\": " << r.matches_per_s << ", \"matches\": " << r.matches << "}";
+        }
+        cout << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    cout << "]\n";
+}
+
+static void WriteCSV(const vector<Result>& results) {
+    cout << "case,engine,skipped,compile_us,mb_per_s,matches_per_s,matches\n";
+    for(const Result& r : results) {
+        cout << r.case_name << ',' << r.engine << ',' << (r.skipped ? 1 : 0) << ',';
+        if(r.skipped) cout << ",,,\n";
+        else cout << r.compile_us << ',' << r.mb_per_s << ',' << r.matches_per_s << ',' << r.matches << '\n';
+    }
+}
+
+int main(int argc, char* argv[]) {
+    string format = "json";
+    string filter;
+    double min_seconds = 0.5;
+    for(int i = 1; i < argc; ++i) {
+        if(std::strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            format = argv[++i];
+        } else if(std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if(std::strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            min_seconds = std::atof(argv[++i]);
+        } else {
+            cerr << "Usage: " << argv[0] << " [--format json|csv] [--filter <substring>] [--seconds <seconds>]\n";
+            return 2;
+        }
+    }
+    if(format != "json" && format != "csv") {
+        cerr << "Unknown format \"" << format << "\".\n";
+        return 2;
+    }
+
+    //Measure real compiles, not cache hits.
+    RegexCache::GetGlobal().SetMemoryBudget(0);
+
+    vector<Result> results;
+    for(const Case& a_case : MakeCases()) {
+        if(a_case.name.find(filter) == string::npos) continue;
+        cerr << a_case.name << "...\n";
+        results.push_back(RunRegex(a_case, min_seconds));
+        results.push_back(RunDFA(a_case, min_seconds));
+        results.push_back(RunDFALayout(a_case, min_seconds));
+        results.push_back(RunStdRegex(a_case, min_seconds));
+    }
+
+    if(format == "json") WriteJSON(results);
+    else WriteCSV(results);
+    return 0;
+}
@@ -0,0 +1,75 @@
+/*
+ * Filename: dfa_codegen.cpp
+ * Programmer: Abdurrahman Alyajouri
+ * Date: 10/17/2026
+ * Purpose: The purpose of this file is to compile a pattern into a C++
+ *          source file with a matcher for it, written as goto code by
+ *          DFACodeGenerator, and optionally a header declaring it. The
+ *          generated files build into any program without this library.
+ *          Like DFA::Match, the matcher checks the whole input, so a
+ *          search for the pattern is written as ".*(?:<pattern>).*".
+ *
+ *          Usage: dfa_codegen [-n <function name>] [-m <max states>]
+ *                             <pattern> <output source> [<output header>]
+ */
+
+#include "../dfa.h"
+#include "../dfa_codegen.h"
+#include "../regex.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using std::cerr;
+using std::cout;
+using std::string;
+using std::vector;
+
+//Writes "contents" to "path". Returns false if the file could not be
+//written.
+static bool WriteFile(const string& path, const string& contents) {
+    std::ofstream out(path, std::ios::binary);
+    out << contents;
+    return static_cast<bool>(out);
+}
+
+int main(int argc, char* argv[]) {
+    string function_name = "Match";
+    size_t max_states = DFA::kDefaultMaxStates;
+    vector<string> arguments;
+    for(int i = 1; i < argc; ++i) {
+        if(std::strcmp(argv[i], "-n") == 0 && i + 1 < argc) function_name = argv[++i];
+        else if(std::strcmp(argv[i], "-m") == 0 && i + 1 < argc) max_states = std::strtoul(argv[++i], nullptr, 10);
+        else arguments.push_back(argv[i]);
+    }
+    if(arguments.size() < 2 || arguments.size() > 3) {
+        cerr << "Usage: " << argv[0] << " [-n <function name>] [-m <max states>] <pattern> <output source> [<output header>]\n";
+        return 2;
+    }
+
+    string source, header;
+    try {
+        DFA dfa(Regex(arguments[0]), max_states);
+        DFACodeGenerator generator(dfa, function_name);
+        source = generator.GenerateSource();
+        header = generator.GenerateHeader();
+        cout << "\"" << arguments[0] << "\" -> " << dfa.GetStateCount() << " states\n";
+    } catch(const std::exception& e) {
+        cerr << e.what() << '\n';
+        return 1;
+    }
+
+    if(!WriteFile(arguments[1], source)) {
+        cerr << "Could not write \"" << arguments[1] << "\".\n";
+        return 1;
+    }
+    if(arguments.size() == 3 && !WriteFile(arguments[2], header)) {
+        cerr << "Could not write \"" << arguments[2] << "\".\n";
+        return 1;
+    }
+    return 0;
+}
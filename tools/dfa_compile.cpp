@@ -0,0 +1,63 @@
+/*
+ * Filename: dfa_compile.cpp
+ * Programmer: Abdurrahman Alyajouri
+ * Date: 10/17/2026
+ * Purpose: The purpose of this file is to compile a file of patterns, one
+ *          per line, into a file of minimized DFAs that DFAFile can memory
+ *          map at startup instead of rebuilding every pattern.
+ *
+ *          Usage: dfa_compile <pattern file> <output file> [max states]
+ */
+
+#include "../dfa.h"
+#include "../regex.h"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using std::cerr;
+using std::cout;
+using std::string;
+using std::vector;
+
+int main(int argc, char* argv[]) {
+    if(argc < 3 || argc > 4) {
+        cerr << "Usage: " << argv[0] << " <pattern file> <output file> [max states]\n";
+        return 2;
+    }
+
+    size_t max_states = DFA::kDefaultMaxStates;
+    if(argc == 4) max_states = std::strtoul(argv[3], nullptr, 10);
+
+    std::ifstream patterns(argv[1]);
+    if(!patterns) {
+        cerr << "Could not open \"" << argv[1] << "\".\n";
+        return 1;
+    }
+
+    //Compile every line, reporting all bad patterns before giving up.
+    vector<DFA> dfas;
+    string line;
+    size_t line_number = 0;
+    bool failed = false;
+    while(std::getline(patterns, line)) {
+        ++line_number;
+        try {
+            dfas.emplace_back(Regex(line), max_states);
+            cout << line_number << ": \"" << line << "\" -> " << dfas.back().GetStateCount() << " states\n";
+        } catch(const std::exception& e) {
+            cerr << argv[1] << ":" << line_number << ": " << e.what() << '\n';
+            failed = true;
+        }
+    }
+    if(failed) return 1;
+
+    if(!DFAFile::Write(argv[2], dfas)) {
+        cerr << "Could not write \"" << argv[2] << "\".\n";
+        return 1;
+    }
+    return 0;
+}
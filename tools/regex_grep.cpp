@@ -0,0 +1,426 @@
+/*
+ * Filename: regex_grep.cpp
+ * Programmer: Abdurrahman Alyajouri
+ * Date: 10/17/2026
+ * Purpose: The purpose of this file is to search files for the lines that
+ *          match a pattern, like grep. Files are memory mapped and cut into
+ *          chunks at line boundaries, which are searched on the threads of a
+ *          ThreadPool with a MatchContext per thread. Every chunk writes its
+ *          output to a buffer of its own, and the buffers are written out in
+ *          input order. Directories are searched recursively, and standard
+ *          input is read if no file is given or for "-".
+ *
+ *          Usage: regex_grep [-c] [-v] [-n] [-j <threads>] [--stats]
+ *                            (<pattern> | -f <pattern file>) [<file or directory>...]
+ *
+ *          -c prints the number of selected lines per file instead of the
+ *          lines, -v selects the lines that don't match, -n puts the line
+ *          number in front of every line and --stats reports the time and
+ *          throughput on standard error. Exits with 0 if a line was
+ *          selected, 1 if none was and 2 on errors.
+ */
+
+#include "../regex.h"
+#include "../thread_pool.h"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using std::cerr;
+using std::string;
+using std::string_view;
+using std::unique_ptr;
+using std::vector;
+
+typedef std::chrono::steady_clock Clock;
+
+//Bytes per chunk. A chunk is extended to the end of the line it stops in.
+constexpr size_t kChunkSize = 1 << 20;
+
+//Chunks searched between two writes of the output, per thread. The chunks
+//of a round and their output are all in memory at once.
+constexpr size_t kChunksPerThread = 8;
+
+//Most chunks in a round, which limits the files a round keeps mapped when
+//searching a directory of small files.
+constexpr size_t kMaxRoundChunks = 4096;
+
+struct Options {
+    bool count = false;
+    bool invert = false;
+    bool line_numbers = false;
+    bool stats = false;
+    bool show_names = false; //Put the file name in front of every line.
+    size_t threads = 1;
+};
+
+//An input file, memory mapped, or read into "buffer" for standard input.
+struct InputFile {
+    string name;
+    const char* data = nullptr;
+    size_t size = 0;
+    void* mapping = nullptr;
+    string buffer;
+    size_t lines = 0; //Lines in the chunks handed out so far, for -n.
+    size_t selected = 0; //Selected lines so far, for -c.
+
+    InputFile() = default;
+    InputFile(const InputFile&) = delete;
+    InputFile& operator=(const InputFile&) = delete;
+    ~InputFile() {
+        if(this->mapping != nullptr) munmap(this->mapping, this->size);
+    }
+};
+
+//A range of lines of a file and what searching it found.
+struct Chunk {
+    InputFile* file;
+    size_t begin;
+    size_t end;
+    bool last; //Whether it ends its file.
+    size_t first_line; //Number of its first line, for -n.
+    size_t lines; //Newlines in the chunk, for -n.
+    size_t selected;
+    string output;
+};
+
+//Maps "path", or reads standard input for "-". Returns false and prints
+//why if that fails.
+static bool OpenInput(const string& path, InputFile& file) {
+    file.name = path;
+    if(path == "-") {
+        char block[1 << 16];
+        size_t read;
+        while((read = std::fread(block, 1, sizeof(block), stdin)) > 0) file.buffer.append(block, read);
+        file.name = "(standard input)";
+        file.data = file.buffer.data();
+        file.size = file.buffer.size();
+        return true;
+    }
+
+    int fd = open(path.c_str(), O_RDONLY);
+    struct stat info;
+    if(fd < 0 || fstat(fd, &info) != 0) {
+        cerr << "regex_grep: " << path << ": " << std::strerror(errno) << '\n';
+        if(fd >= 0) close(fd);
+        return false;
+    }
+    file.size = static_cast<size_t>(info.st_size);
+    if(file.size > 0) {
+        file.mapping = mmap(nullptr, file.size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(file.mapping == MAP_FAILED) {
+            cerr << "regex_grep: " << path << ": " << std::strerror(errno) << '\n';
+            file.mapping = nullptr;
+            close(fd);
+            return false;
+        }
+        madvise(file.mapping, file.size, MADV_SEQUENTIAL);
+        file.data = static_cast<const char*>(file.mapping);
+    }
+    close(fd);
+    return true;
+}
+
+//Appends the regular files under every directory in "paths" in place of
+//the directory, in sorted order. Returns false if a path doesn't exist.
+static bool ExpandPaths(const vector<string>& paths, vector<string>& files, bool& has_directory) {
+    bool ok = true;
+    for(const string& path : paths) {
+        std::error_code error;
+        if(path == "-" || !std::filesystem::is_directory(path, error)) {
+            files.push_back(path);
+            continue;
+        }
+        has_directory = true;
+
+        vector<string> found;
+        auto options = std::filesystem::directory_options::skip_permission_denied;
+        for(std::filesystem::recursive_directory_iterator it(path, options, error), end; !error && it != end; it.increment(error)) {
+            if(it->is_regular_file(error)) found.push_back(it->path().string());
+        }
+        if(error) {
+            cerr << "regex_grep: " << path << ": " << error.message() << '\n';
+            ok = false;
+        }
+        std::sort(found.begin(), found.end());
+        files.insert(files.end(), found.begin(), found.end());
+    }
+    return ok;
+}
+
+//Builds the pattern from a file with one pattern per line, as an
+//alternation of all of them.
+static bool ReadPatternFile(const string& path, string& pattern) {
+    std::ifstream in(path);
+    if(!in) {
+        cerr << "regex_grep: " << path << ": " << std::strerror(errno) << '\n';
+        return false;
+    }
+    vector<string> patterns;
+    string line;
+    while(std::getline(in, line)) patterns.push_back(line);
+    if(patterns.size() == 1) {
+        pattern = patterns[0];
+        return true;
+    }
+
+    //"(?:...)" doesn't capture, so an alternation of plain words still
+    //compiles to an Aho-Corasick automaton.
+    for(size_t i = 0; i < patterns.size(); ++i) {
+        if(i > 0) pattern += '|';
+        pattern += "(?:" + patterns[i] + ")";
+    }
+    return true;
+}
+
+//Appends "number" and a ':' to "out".
+static void AppendNumber(string& out, size_t number) {
+    char digits[24];
+    char* end = std::to_chars(digits, digits + sizeof(digits), number).ptr;
+    out.append(digits, end - digits);
+    out += ':';
+    return;
+}
+
+//Searches the lines of "chunk". If "whole_chunk" is set, no match of "re"
+//can span two lines, so the chunk is searched as one string and the lines
+//between two matches are skipped over without looking at them again.
+//Otherwise "re" is the pattern surrounded by ".*", and every line is
+//matched against it on its own.
+static void SearchChunk(const Regex& re, bool whole_chunk, const Options& options, Chunk& chunk) {
+    thread_local MatchContext context;
+
+    string_view text(chunk.file->data + chunk.begin, chunk.end - chunk.begin);
+    size_t line_number = chunk.first_line;
+    chunk.selected = 0;
+    chunk.output.clear();
+
+    //Handles the line from "begin" up to the '\n' at "end", or the end of
+    //the chunk, if the line is selected.
+    auto select = [&](size_t begin, size_t end) {
+        ++chunk.selected;
+        if(options.count) return;
+        if(options.show_names) {
+            chunk.output += chunk.file->name;
+            chunk.output += ':';
+        }
+        if(options.line_numbers) AppendNumber(chunk.output, line_number);
+        chunk.output.append(text.data() + begin, end - begin);
+        chunk.output += '\n';
+    };
+
+    //Returns the end of the line "pos" is in.
+    auto line_end = [&](size_t pos) {
+        const void* newline = std::memchr(text.data() + pos, '\n', text.size() - pos);
+        return newline == nullptr ? text.size() : static_cast<const char*>(newline) - text.data();
+    };
+
+    if(!whole_chunk) {
+        for(size_t begin = 0; begin < text.size(); ++line_number) {
+            size_t end = line_end(begin);
+            if(re.Match(text.substr(begin, end - begin), context) != options.invert) select(begin, end);
+            begin = end + 1;
+        }
+        return;
+    }
+
+    //Lines from "begin" up to the line starting at "end" have no match.
+    auto skip = [&](size_t begin, size_t end) {
+        if(!options.invert) {
+            if(options.line_numbers) line_number += std::count(text.data() + begin, text.data() + end, '\n');
+            return;
+        }
+        for(; begin < end; ++line_number) {
+            size_t stop = line_end(begin);
+            select(begin, stop);
+            begin = stop + 1;
+        }
+    };
+
+    size_t pos = 0;
+    while(pos < text.size()) {
+        optional<RegexMatch> match = re.Find(text, context, pos);
+        if(!match.has_value()) {
+            skip(pos, text.size());
+            break;
+        }
+
+        //The match starts on the line that follows the last '\n' before it.
+        //A match right behind the last '\n' of the chunk is on no line.
+        size_t begin = match->begin;
+        while(begin > pos && text[begin - 1] != '\n') --begin;
+        skip(pos, begin);
+        if(begin == text.size()) break;
+        size_t end = line_end(match->begin);
+        if(!options.invert) select(begin, end);
+        ++line_number;
+        pos = end + 1;
+    }
+    return;
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    options.threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    string pattern;
+    bool has_pattern = false;
+    bool bad_option = false;
+    vector<string> paths;
+    for(int i = 1; i < argc; ++i) {
+        if(std::strcmp(argv[i], "-c") == 0) {
+            options.count = true;
+        } else if(std::strcmp(argv[i], "-v") == 0) {
+            options.invert = true;
+        } else if(std::strcmp(argv[i], "-n") == 0) {
+            options.line_numbers = true;
+        } else if(std::strcmp(argv[i], "--stats") == 0) {
+            options.stats = true;
+        } else if(std::strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            options.threads = std::max<size_t>(std::strtoul(argv[++i], nullptr, 10), 1);
+        } else if(std::strcmp(argv[i], "-f") == 0 && i + 1 < argc && !has_pattern) {
+            if(!ReadPatternFile(argv[++i], pattern)) return 2;
+            has_pattern = true;
+        } else if(argv[i][0] == '-' && argv[i][1] != '\0') {
+            bad_option = true;
+        } else if(!has_pattern) {
+            pattern = argv[i];
+            has_pattern = true;
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if(!has_pattern || bad_option) {
+        cerr << "Usage: " << argv[0] << " [-c] [-v] [-n] [-j <threads>] [--stats]"
+             << " (<pattern> | -f <pattern file>) [<file or directory>...]\n";
+        return 2;
+    }
+    if(paths.empty()) paths.push_back("-");
+
+    Clock::time_point compile_start = Clock::now();
+    unique_ptr<Regex> re;
+    bool whole_chunk = false;
+    try {
+        re = std::make_unique<Regex>(pattern);
+
+        //Matching a line as a whole runs on the faster engines of Match.
+        whole_chunk = !re->CanContainByte('\n');
+        if(!whole_chunk) re = std::make_unique<Regex>(".*(?:" + pattern + ").*");
+    } catch(const std::exception& e) {
+        cerr << "regex_grep: " << e.what() << '\n';
+        return 2;
+    }
+    double compile_seconds = std::chrono::duration<double>(Clock::now() - compile_start).count();
+
+    bool has_directory = false;
+    vector<string> files;
+    bool failed = !ExpandPaths(paths, files, has_directory);
+    options.show_names = files.size() > 1 || has_directory;
+
+    //The calling thread helps the pool out, so it needs one thread less.
+    unique_ptr<ThreadPool> pool;
+    if(options.threads > 1) pool = std::make_unique<ThreadPool>(options.threads - 1);
+    auto run = [&pool](size_t count, const std::function<void(size_t)>& task) {
+        if(pool) pool->Run(count, task);
+        else for(size_t i = 0; i < count; ++i) task(i);
+    };
+
+    std::setvbuf(stdout, nullptr, _IOFBF, 1 << 20);
+    Clock::time_point start = Clock::now();
+    size_t total_bytes = 0;
+    size_t total_selected = 0;
+
+    //Chunks are searched in rounds. A round's chunks all run at once, and
+    //their output is written in order once the round is over.
+    size_t round_bytes = options.threads * kChunksPerThread * kChunkSize;
+    vector<Chunk> chunks(kMaxRoundChunks);
+    size_t chunk_count = 0;
+    size_t pending_bytes = 0;
+    vector<unique_ptr<InputFile>> finished; //Files all chunks were handed out of.
+    auto flush = [&](void) {
+        if(options.line_numbers && !options.count) {
+            run(chunk_count, [&chunks](size_t i) {
+                Chunk& chunk = chunks[i];
+                chunk.lines = std::count(chunk.file->data + chunk.begin, chunk.file->data + chunk.end, '\n');
+            });
+            for(size_t i = 0; i < chunk_count; ++i) {
+                chunks[i].first_line = chunks[i].file->lines + 1;
+                chunks[i].file->lines += chunks[i].lines;
+            }
+        }
+        run(chunk_count, [&](size_t i) { SearchChunk(*re, whole_chunk, options, chunks[i]); });
+
+        for(size_t i = 0; i < chunk_count; ++i) {
+            Chunk& chunk = chunks[i];
+            std::fwrite(chunk.output.data(), 1, chunk.output.size(), stdout);
+            chunk.file->selected += chunk.selected;
+            total_selected += chunk.selected;
+            if(!options.count || !chunk.last) continue;
+            if(options.show_names) std::printf("%s:", chunk.file->name.c_str());
+            std::printf("%zu\n", chunk.file->selected);
+        }
+        chunk_count = 0;
+        pending_bytes = 0;
+        finished.clear();
+    };
+
+    for(const string& path : files) {
+        unique_ptr<InputFile> file = std::make_unique<InputFile>();
+        if(!OpenInput(path, *file)) {
+            failed = true;
+            continue;
+        }
+        total_bytes += file->size;
+
+        //An empty file still gets a chunk, so -c reports it.
+        const char* data = file->data;
+        size_t size = file->size;
+        size_t begin = 0;
+        do {
+            size_t end = std::min(begin + kChunkSize, size);
+            if(end < size) {
+                const void* newline = std::memchr(data + end, '\n', size - end);
+                end = newline == nullptr ? size : static_cast<const char*>(newline) - data + 1;
+            }
+            Chunk& chunk = chunks[chunk_count++];
+            chunk.file = file.get();
+            chunk.begin = begin;
+            chunk.end = end;
+            chunk.last = end == size;
+            chunk.first_line = 1;
+            pending_bytes += end - begin;
+            begin = end;
+            if(chunk.last) finished.push_back(std::move(file));
+            if(chunk_count == chunks.size() || pending_bytes >= round_bytes) flush();
+        } while(begin < size);
+    }
+    flush();
+    std::fflush(stdout);
+
+    if(options.stats) {
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        std::fprintf(stderr, "%zu files, %.1f MB in %.3f s (%.2f GB/s) on %zu threads, %zu lines selected, compiled in %.3f ms\n",
+                     files.size(), total_bytes / 1e6, seconds, total_bytes / 1e9 / std::max(seconds, 1e-9),
+                     options.threads, total_selected, compile_seconds * 1e3);
+    }
+    if(failed) return 2;
+    return total_selected > 0 ? 0 : 1;
+}